@@ -0,0 +1,34 @@
+/* discovery
+ * License: GPLv2
+ * See LICENSE.txt for full license text
+ *
+ * FILE: Accuracy.h
+ * DATE: October 19th, 2026
+ * DESCRIPTION: compile time accuracy policies the cpu and ppu are templated on
+ */
+
+#pragma once
+
+/*
+ * Both policies are instantiated into the binary and one is picked at startup
+ * (see Discovery::GameLoop). Every check against a policy is an `if constexpr`,
+ * so the fast core carries none of the accuracy branches.
+ */
+
+// exact timing, for test roms and raster effects
+struct AccuracyCycle
+{
+    static constexpr bool waitstates        = true; // charge WAITCNT N/S waitstates in Arm7Tdmi::Tick, else fixed ones
+    static constexpr bool bios_open_bus     = true; // reads from BIOS outside of BIOS return last_read_bios
+    static constexpr bool misaligned_rotate = true; // misaligned LDR/SWP/LDRH rotate the aligned word
+    static constexpr bool scanline_render   = true; // render each scanline at HBlank instead of once per frame
+};
+
+// correct output as fast as possible, for bulk screenshotting
+struct AccuracyFast
+{
+    static constexpr bool waitstates        = false;
+    static constexpr bool bios_open_bus     = false;
+    static constexpr bool misaligned_rotate = true; // games rely on it, and it only costs a test of the low address bits
+    static constexpr bool scanline_render   = false;
+};
@@ -14,7 +14,10 @@
 #include "Util.h"
 #include "PPU.h"
 #include "mmio.h"
+#include "Accuracy.h"
 
+// Accuracy is one of the policies in Accuracy.h
+template <typename Accuracy>
 class Arm7Tdmi
 {
     public:
@@ -47,6 +50,9 @@ class Arm7Tdmi
         bool swi_vblank_intr;
         u32  current_interrupt;
         u32  cycles;
+        u32  clock_multiplier; // overclock, 8.8 fixed point (0x100 = stock 16.78 MHz)
+        u32  cycle_fraction;   // part of a cycle Tick couldn't charge yet, in the same units
+        u8   decoded; // ArmInstruction or ThumbInstruction of the instruction being executed
 
         struct registers
         {
@@ -105,6 +111,12 @@ class Arm7Tdmi
         void Decode(u32);
         void Execute(u32);
 
+        #ifdef THREADED_DISPATCH
+        // threaded replacement for the Fetch / Decode / Execute loop in Discovery::Run
+        // catch_up(ctx, cycles) is called after each instruction to run the rest of the system
+        void Run(bool &running, void (*catch_up)(void *, u32), void *ctx);
+        #endif
+
         void Tick(u8, u8, u8);
 
         u32 GetRegister(u32);
@@ -170,6 +182,9 @@ class Arm7Tdmi
         void SetState(State state) { registers.cpsr.flags.t = state == State::THUMB ? 1 : 0; }
         
     private:
+        void ExecuteArm(u32, ArmInstruction);
+        void ExecuteThumb(u16, ThumbInstruction);
+
         // safely interface with memory
         u8   Read8(u32);
         u32  Read16(u32, bool);
@@ -185,6 +200,7 @@ class Arm7Tdmi
         void UpdateFlagsAddition(u32, u32, u32);
         void UpdateFlagsSubtraction(u32, u32, u32);
         void IncrementPC();
+        void ChargeCycles(u32);
         void UpdateCPSR(u32, bool);
         void UpdateSPSR(u32, bool);
         bool ConditionMet(Condition);
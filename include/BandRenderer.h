@@ -0,0 +1,46 @@
+/* discovery
+ * License: GPLv2
+ * See LICENSE.txt for full license text
+ *
+ * FILE: BandRenderer.h
+ * DATE: October 19th, 2026
+ * DESCRIPTION: draws a whole frame as bands of scanlines spread across cores
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "Renderer.h"
+#include "ThreadPool.h"
+
+constexpr int BAND_LINES = 8; // scanlines per task, 20 tasks per frame
+
+/*
+ * Once a frame's registers are in a ScanlineLog its lines don't depend on each other,
+ * so each pool thread draws bands with a Renderer of its own (line buffers and sprite
+ * bins are per renderer) straight into their rows of the screen. The caches are shared:
+ * each DrawLines decodes everything stale up front, after which the renderers only read them.
+ */
+class BandRenderer
+{
+    public:
+        BandRenderer(TileCache *, PaletteCache *, OamCache *, int threads);
+
+        void Reset();
+
+        // draw every VDraw line of log into screen, whose rows are pitch bytes apart, and each line's hash into hashes
+        void DrawFrame(const ScanlineLog &log, void *screen, int pitch, u64 *hashes);
+
+        // the same for lines first up to last only, video memory may change between calls
+        void DrawLines(const ScanlineLog &log, int first, int last, void *screen, int pitch, u64 *hashes);
+
+    private:
+        TileCache    *tiles;
+        PaletteCache *palette;
+        OamCache     *objs;
+
+        ThreadPool pool;
+        std::vector<std::unique_ptr<Renderer>> renderers; // one per pool thread
+};
@@ -10,6 +10,7 @@
 #pragma once
 
 #include <vector>
+#include <atomic>
 
 #include "Arm7Tdmi.h"
 #include "PPU.h"
@@ -23,7 +24,10 @@ class Discovery
     public:
         Discovery();
 
-        Arm7Tdmi  *cpu;
+        // only the core selected by config::fast is constructed
+        Arm7Tdmi<AccuracyCycle> *cpu;
+        Arm7Tdmi<AccuracyFast>  *fast_cpu;
+
         PPU       *ppu;
         Memory    *mem;
         LcdStat   *stat;
@@ -31,14 +35,32 @@ class Discovery
         Timer     *timers[4];
 
         long system_cycles;
+        u32  old_cycles; // cycles the rest of the system has caught up to
         bool running;
 
-        SDL_Event e;
+        // input from the main thread, which polls window events and presents frames while the cpu runs on another
+        // applied by Tick at VBlank
+        std::atomic<u16>  keys;          // KEYINPUT
+        std::atomic<bool> quit;          // the window was closed
+        std::atomic<bool> toggle_turbo;  // tab was pressed
+        std::atomic<bool> stopped;       // set by the cpu's thread once Run returns
 
         std::vector<std::string> argv;
 
         void GameLoop();
+        void PollEvents();
+
+        template <typename Accuracy>
+        void Run(Arm7Tdmi<Accuracy> *);
+
+        template <typename Accuracy>
+        void CatchUp(u32);
+
+        template <typename Accuracy>
         void Tick();
+
+        void LoadGameConfig();
+        void ParseFrameSkip();
         void ParseArgs();
         void PrintArgHelp();
         void ShutDown();
@@ -0,0 +1,71 @@
+/* discovery
+ * License: GPLv2
+ * See LICENSE.txt for full license text
+ *
+ * FILE: FrameDamage.h
+ * DATE: October 19th, 2026
+ * DESCRIPTION: which lines of a frame changed since the last one presented, from per-line hashes
+ */
+
+#pragma once
+
+#include <cstring>
+
+#include "Renderer.h"
+
+// 64 bit multiply / xor hash of a line of bytes bytes (a multiple of 8), taken by the renderer before the line is written out
+inline u64 HashLine(const void *line, int bytes)
+{
+    u64 hash = 0x9E3779B97F4A7C15ULL;
+
+    for (int i = 0; i < bytes; i += 8)
+    {
+        u64 word;
+        std::memcpy(&word, (const u8 *) line + i, sizeof(word));
+
+        hash = (hash ^ word) * 0xFF51AFD7ED558CCDULL;
+        hash ^= hash >> 32;
+    }
+
+    return hash;
+}
+
+/*
+ * The Presenter compares every presented frame's line hashes with the last presented frame's,
+ * and sinks get the result with the frame: nothing changed, or which lines did. Lines
+ * are full width, so a run of dirty lines is a dirty rectangle.
+ */
+struct FrameDamage
+{
+    bool dirty[SCREEN_HEIGHT];
+    int  count; // dirty lines
+
+    bool Any() const { return count != 0; }
+    bool All() const { return count == SCREEN_HEIGHT; }
+
+    void MarkAll()
+    {
+        std::memset(dirty, 1, sizeof(dirty));
+        count = SCREEN_HEIGHT;
+    }
+
+    // call f(first, last) for every run of dirty lines [first, last)
+    template <typename F>
+    void ForEachRun(F f) const
+    {
+        for (int line = 0; line < SCREEN_HEIGHT; )
+        {
+            if (!dirty[line])
+            {
+                ++line;
+                continue;
+            }
+
+            int first = line;
+            while (line < SCREEN_HEIGHT && dirty[line])
+                ++line;
+
+            f(first, line);
+        }
+    }
+};
@@ -0,0 +1,63 @@
+/* discovery
+ * License: GPLv2
+ * See LICENSE.txt for full license text
+ *
+ * FILE: FramePacer.h
+ * DATE: October 19th, 2026
+ * DESCRIPTION: holds emulation to the gba's refresh rate on the monotonic clock, and times frames
+ */
+
+#pragma once
+
+#include "common.h"
+
+constexpr double GBA_REFRESH_RATE = 16777216.0 / 280896; // ~59.73 Hz, cpu clock / cycles per frame
+
+/*
+ * Every frame has an absolute deadline on CLOCK_MONOTONIC, one period after the last
+ * one, so time lost to a late wakeup is made up on the next frame instead of adding
+ * up. EndFrame sleeps until shortly before the deadline and spins for the rest, which
+ * costs a few hundred microseconds of cpu per frame rather than a whole core. The spin
+ * margin follows how late the kernel has been waking us, within MIN_SPIN - MAX_SPIN.
+ *
+ * A frame that ends after its deadline is counted late and not waited for. When the
+ * emulator falls more than MAX_BEHIND frames behind (a stall, a debugger, turbo) the
+ * deadlines restart from now rather than racing to catch up.
+ */
+class FramePacer
+{
+    public:
+        struct Stats
+        {
+            u64 frames; // frame times measured
+            u64 late;   // paced frames that missed their deadline
+            double mean_ms, stddev_ms, min_ms, max_ms;
+        };
+
+        explicit FramePacer(double hz = GBA_REFRESH_RATE);
+
+        // nanoseconds on CLOCK_MONOTONIC
+        static u64 Now();
+
+        // call once per frame, wait is false to run uncapped
+        void EndFrame(bool wait);
+
+        Stats GetStats() const;
+
+    private:
+        static constexpr u64 MIN_SPIN   = 100000;  // ns
+        static constexpr u64 MAX_SPIN   = 2000000;
+        static constexpr u64 MAX_BEHIND = 4;       // frames
+
+        u64 period;   // ns
+        u64 deadline; // end of the current frame, 0 until the first EndFrame
+        u64 spin;     // ns before a deadline to stop sleeping and start spinning
+
+        // frame times, Welford's running mean / variance
+        u64 last_end;
+        u64 frames, late;
+        double mean, m2, min, max;
+
+        void WaitUntil(u64 time);
+        void Record(u64 now);
+};
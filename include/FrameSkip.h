@@ -0,0 +1,94 @@
+/* discovery
+ * License: GPLv2
+ * See LICENSE.txt for full license text
+ *
+ * FILE: FrameSkip.h
+ * DATE: October 19th, 2026
+ * DESCRIPTION: decides which frames the ppu draws - all, N of every M, as host time allows, or turbo
+ */
+
+#pragma once
+
+#include <chrono>
+
+#include "common.h"
+#include "FramePacer.h"
+
+/*
+ * A skipped frame runs every scanline as usual, so VCount, HBlank / VBlank, their IRQs
+ * and DMAs are untouched, but nothing is drawn or presented. The ppu asks Next at every
+ * VBlank whether to draw the frame after it.
+ *
+ * Fixed skips the first skip frames of every of frames. Automatic keeps a real time
+ * deadline for every frame and skips while more than a frame behind it, at most
+ * MAX_AUTO_SKIP in a row so the picture keeps moving. Turbo overrides both and only
+ * draws a frame when a refresh period of host time has passed since the last one,
+ * which is about all a monitor can show while the cpu runs as fast as it can.
+ */
+class FrameSkip
+{
+    public:
+        static constexpr int MAX_AUTO_SKIP = 4;
+
+        int  skip      = 0; // fixed, first skip frames of every of are skipped
+        int  of        = 1;
+        bool automatic = false;
+        bool turbo     = false;
+
+        u64 skipped = 0; // frames not drawn so far
+
+        // true if the next frame should be drawn
+        bool Next()
+        {
+            bool draw = Decide();
+
+            if (!draw)
+                ++skipped;
+
+            return draw;
+        }
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        const Clock::duration period = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1 / GBA_REFRESH_RATE));
+
+        int count = 0;       // position in the fixed pattern
+        int consecutive = 0; // frames skipped in a row
+        Clock::time_point deadline, last_drawn;
+
+        bool Decide()
+        {
+            auto now = Clock::now();
+
+            if (turbo)
+            {
+                if (now - last_drawn < period)
+                    return false;
+
+                last_drawn = now;
+                return true;
+            }
+
+            if (automatic)
+            {
+                deadline += period;
+
+                // too far behind to catch up (paused, or just started), start over from now
+                if (now - deadline > period * 8)
+                    deadline = now;
+
+                if (now - deadline > period && consecutive < MAX_AUTO_SKIP)
+                {
+                    ++consecutive;
+                    return false;
+                }
+
+                consecutive = 0;
+                return true;
+            }
+
+            count = (count + 1) % of;
+            return count >= skip;
+        }
+};
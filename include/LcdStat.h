@@ -59,9 +59,23 @@ struct LcdStat
         int voff,  hoff;   // vertical, horizontal offsets
     } bgcnt[4]; // backgrounds 0-3
 
+    // affine parameters of BG2, BG3 (BGxPA - BGxPD, BGxX / BGxY)
+    struct BgAffine
+    {
+        s16 pa, pb, pc, pd; // 8.8 fixed point P matrix
+        s32 x,  y;          // 20.8 fixed point reference point as written
+
+        // internal reference point the ppu draws from, reloaded from x, y at VBlank
+        // and whenever they are written, and advanced by pb, pd after every scanline
+        s32 ref_x, ref_y;
+    } bgaffine[2]; // backgrounds 2-3
+
+    bool regs_dirty; // a display register was written since the ppu's last ScanlineLog snapshot
+
     LcdStat()
     {
         scanline = 0;
+        regs_dirty = true;
 
         // zero reg_dispcnt
         dispcnt.mode         = 0; 
@@ -100,6 +114,19 @@ struct LcdStat
             bgcnt[i].voff        = 0;
             bgcnt[i].hoff        = 0;
         }
+
+        // identity matrix at the origin
+        for (int i = 0; i < 2; ++i)
+        {
+            bgaffine[i].pa    = 0x100;
+            bgaffine[i].pb    = 0;
+            bgaffine[i].pc    = 0;
+            bgaffine[i].pd    = 0x100;
+            bgaffine[i].x     = 0;
+            bgaffine[i].y     = 0;
+            bgaffine[i].ref_x = 0;
+            bgaffine[i].ref_y = 0;
+        }
     }
 
     ~LcdStat() { }
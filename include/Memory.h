@@ -15,6 +15,10 @@
 #include "LcdStat.h"
 #include "common.h"
 #include "Timer.h"
+#include "TileCache.h"
+#include "PaletteCache.h"
+#include "OamCache.h"
+#include "VideoWriteLog.h"
 #include "mmio.h"
 #include "log.h"
 
@@ -46,6 +50,10 @@ constexpr u32 MEM_VRAM_SIZE        = 0x20000;
 constexpr u32 MEM_OAM_SIZE         = 0x400;
 constexpr u32 MEM_SIZE             = 0x8000000;
 
+// N and S waitstates WAITCNT gives at power on
+constexpr u8 DEFAULT_N_CYCLES = 4;
+constexpr u8 DEFAULT_S_CYCLES = 2;
+
 class Memory
 {
     public:
@@ -61,6 +69,14 @@ class Memory
         u8 *cart_ram;
         size_t rom_size;
         size_t ram_size;
+
+        // decoded VRAM tiles, host palette colors and sprites for the ppu, kept in sync by the write functions
+        TileCache    tiles;
+        PaletteCache palette;
+        OamCache     objs;
+
+        // where writes to the three go as well while a RenderThread draws from its own copy, NULL otherwise
+        VideoWriteLog *video_writes;
         
         struct DMA
         {
@@ -84,6 +100,8 @@ class Memory
 
         u8 haltcnt;
 
+        bool keyinput_read; // KEYINPUT was read since the last VBlank, see PPU::lag_frames
+
         void Reset();
         bool LoadRom(const std::string &);
         bool LoadBios(const std::string &);
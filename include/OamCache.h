@@ -0,0 +1,182 @@
+/* discovery
+ * License: GPLv2
+ * See LICENSE.txt for full license text
+ *
+ * FILE: OamCache.h
+ * DATE: October 19th, 2026
+ * DESCRIPTION: OAM entries and affine matrices decoded for the ppu, refreshed from dirty bits
+ */
+
+#pragma once
+
+#include "common.h"
+
+/*
+ * OAM holds 128 entries of 8 bytes. Bytes 0 - 5 of an entry are its attributes, and
+ * bytes 6 - 7 of entries 4n - 4n+3 are the pa, pb, pc, pd of affine matrix n.
+ * Memory::Write8 / Write8Unsafe mark the entry or matrix a byte belongs to dirty, so
+ * cpu and DMA writes are both covered, and the ppu calls Refresh before drawing to
+ * decode only what changed. Each field is its own array so the sprite loops touch
+ * only the fields they read.
+ */
+class OamCache
+{
+    public:
+        static constexpr int NUM_ENTRIES  = 128;
+        static constexpr int NUM_MATRICES = 32;
+
+        const u8 *oam; // &memory[MEM_OAM_START]
+
+        u32 generation; // bumped by Refresh whenever an entry changes, so renderers know to re-bin
+
+        // center of the sprite on screen (double-size sprites included)
+        s16 x[NUM_ENTRIES];
+        s16 y[NUM_ENTRIES];
+
+        // dimensions of the texture, and half the dimensions of the area drawn on screen
+        u8 width[NUM_ENTRIES];
+        u8 height[NUM_ENTRIES];
+        u8 hwidth[NUM_ENTRIES];
+        u8 hheight[NUM_ENTRIES];
+
+        u8  obj_mode[NUM_ENTRIES];     // 0 - normal render, 1 - affine, 2 - hidden, 3 - double-wide affine
+        u8  gfx_mode[NUM_ENTRIES];     // 0 - normal, 1 - semi-transparent, 2 - obj window, 3 - illegal
+        u8  color_mode[NUM_ENTRIES];   // 256 color if on, 16 color if off
+        u8  mosaic[NUM_ENTRIES];
+        u8  affine_index[NUM_ENTRIES]; // P matrix index (0 - 31)
+        u8  h_flip[NUM_ENTRIES];       // flips are cleared for affine sprites
+        u8  v_flip[NUM_ENTRIES];
+        u16 tileno[NUM_ENTRIES];       // base tile index of sprite
+        u8  priority[NUM_ENTRIES];
+        u8  palbank[NUM_ENTRIES];      // use in 16 color mode
+
+        // affine matrices, 8.8 fixed point
+        s16 pa[NUM_MATRICES];
+        s16 pb[NUM_MATRICES];
+        s16 pc[NUM_MATRICES];
+        s16 pd[NUM_MATRICES];
+
+        OamCache() : generation(1) { InvalidateAll(); }
+
+        // a byte at OAM offset was written
+        inline void Invalidate(u32 offset)
+        {
+            offset &= 0x3FF;
+
+            if ((offset & 7) < 6)
+                dirty_entries[offset >> 9] |= 1ULL << (offset >> 3 & 63);
+            else
+                dirty_matrices |= 1u << (offset >> 5);
+        }
+
+        void InvalidateAll()
+        {
+            dirty_entries[0] = dirty_entries[1] = ~0ULL;
+            dirty_matrices = ~0u;
+        }
+
+        // decode the entries and matrices written since the last call
+        // return true if an entry changed, which may have moved or resized a sprite
+        inline bool Refresh()
+        {
+            bool changed = dirty_entries[0] || dirty_entries[1];
+
+            if (changed)
+                ++generation;
+
+            for (int i = 0; i < NUM_ENTRIES / 64; ++i)
+            {
+                while (dirty_entries[i])
+                {
+                    DecodeEntry(i * 64 + __builtin_ctzll(dirty_entries[i]));
+                    dirty_entries[i] &= dirty_entries[i] - 1;
+                }
+            }
+
+            while (dirty_matrices)
+            {
+                DecodeMatrix(__builtin_ctz(dirty_matrices));
+                dirty_matrices &= dirty_matrices - 1;
+            }
+
+            return changed;
+        }
+
+    private:
+        u64 dirty_entries[NUM_ENTRIES / 64];
+        u32 dirty_matrices;
+
+        inline u16 Read16(u32 offset) const { return oam[offset] | oam[offset + 1] << 8; }
+
+        void DecodeEntry(int i)
+        {
+            // width, height by [shape][size], shape 3 is prohibited
+            static constexpr u8 dimensions[4][4][2] =
+            {
+                { {  8,  8 }, { 16, 16 }, { 32, 32 }, { 64, 64 } },
+                { { 16,  8 }, { 32,  8 }, { 32, 16 }, { 64, 32 } },
+                { {  8, 16 }, {  8, 32 }, { 16, 32 }, { 32, 64 } },
+                { {  0,  0 }, {  0,  0 }, {  0,  0 }, {  0,  0 } },
+            };
+
+            u16 attr0 = Read16(i * 8 + 0);
+            u16 attr1 = Read16(i * 8 + 2);
+            u16 attr2 = Read16(i * 8 + 4);
+
+            int y0          = attr0 >>  0 & 0xFF;
+            obj_mode[i]     = attr0 >>  8 & 0x3;
+            gfx_mode[i]     = attr0 >> 10 & 0x3;
+            mosaic[i]       = attr0 >> 12 & 0x1;
+            color_mode[i]   = attr0 >> 13 & 0x1;
+            int shape       = attr0 >> 14 & 0x3;
+
+            int x0          = attr1 >>  0 & 0x1FF;
+            affine_index[i] = attr1 >>  9 & 0x1F;
+            h_flip[i]       = attr1 >> 12 & 0x1;
+            v_flip[i]       = attr1 >> 13 & 0x1;
+            int size        = attr1 >> 14 & 0x3;
+
+            tileno[i]       = attr2 >>  0 & 0x3FF;
+            priority[i]     = attr2 >> 10 & 0x3;
+            palbank[i]      = attr2 >> 12 & 0xF;
+
+            if (x0 >= 240) x0 -= 512;
+            if (y0 >= 160) y0 -= 256;
+
+            width[i]   = dimensions[shape][size][0];
+            height[i]  = dimensions[shape][size][1];
+            hwidth[i]  = width[i]  / 2;
+            hheight[i] = height[i] / 2;
+
+            // x, y of sprite origin
+            x[i] = x0 + hwidth[i];
+            y[i] = y0 + hheight[i];
+
+            if (obj_mode[i] == 1 || obj_mode[i] == 3) // affine
+            {
+                // double wide affine
+                if (obj_mode[i] == 3)
+                {
+                    x[i] += hwidth[i];
+                    y[i] += hheight[i];
+
+                    hwidth[i]  *= 2;
+                    hheight[i] *= 2;
+                }
+
+                // make sure flips are set to zero
+                h_flip[i] = 0;
+                v_flip[i] = 0;
+            }
+        }
+
+        // P = [pa pb]
+        //     [pc pd]
+        void DecodeMatrix(int n)
+        {
+            pa[n] = Read16(n * 32 +  0x6);
+            pb[n] = Read16(n * 32 +  0xE);
+            pc[n] = Read16(n * 32 + 0x16);
+            pd[n] = Read16(n * 32 + 0x1E);
+        }
+};
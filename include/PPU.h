@@ -9,18 +9,23 @@
  */
 #pragma once
 
-#include <SDL2/SDL.h>
 #include <iostream>
-#include <ctime>
 #include <memory>
-#include <stack>
+#include <atomic>
 
 #include "Memory.h"
 #include "common.h"
 #include "mmio.h"
+#include "Accuracy.h"
+#include "ScanlineLog.h"
+#include "Renderer.h"
+#include "VideoSink.h"
+#include "FrameSkip.h"
+#include "TripleBuffer.h"
+
+class RenderThread;
+class BandRenderer;
 
-constexpr int SCREEN_WIDTH        = 240;
-constexpr int SCREEN_HEIGHT       = 160;
 constexpr int MAX_X               = 512;
 constexpr int MAX_Y               = 256;
 
@@ -29,19 +34,6 @@ constexpr int HBLANK              = 272; // # of cycles in HBlank
 constexpr int VDRAW               = 160; // # of scanlines in VDraw
 constexpr int VBLANK              = 68;  // # of scanlines in VBlank
 
-constexpr int CHARBLOCK_LEN       = 0x4000;
-constexpr int SCREENBLOCK_LEN     = 0x800;
-
-constexpr int PALBANK_LEN         = 32; // length of each of palette RAM's 16 banks in 4bpp mode (s-tiles)
-
-constexpr int NUM_OBJS            = 128; // number of sprites that can be rendered
-
-constexpr u32 LOWER_SPRITE_BLOCK  = 0x6010000;
-constexpr u32 HIGHER_SPRITE_BLOCK = 0x6014000;
-
-constexpr u32 BG_PALETTE          = 0x5000000;
-constexpr u32 SPRITE_PALETTE      = 0x5000200;
-
 class PPU
 {
     public:
@@ -54,78 +46,102 @@ class PPU
         u32 cycles;
         u8 scanline;
 
+        u32 lag_frames; // frames in which the game never read KEYINPUT
+
+        // which frames get drawn, timing and interrupts run for every frame regardless
+        FrameSkip frameskip;
+
+        // hold emulation to GBA_REFRESH_RATE unless limit is off or in turbo, and time every frame
+        FramePacer pacer;
+        bool limit;
+
+        // Accuracy is one of the policies in Accuracy.h
+        template <typename Accuracy>
         void Tick();
         
         void Reset();
 
-    private:
-        SDL_Window  *window;
-        SDL_Surface *final_screen;
-        SDL_Surface *original_screen;
-        SDL_Rect     scale_rect;
+        // draw VDraw from the scanline log (the fast ppu's once per frame render, or a replay)
+        void RenderFrame();
 
-        u8 frame; // counts 0 - 60
-        u8 fps;
-        clock_t old_time;
+        // move drawing to a worker thread, see RenderThread, and split frames across threads cores
+        void StartRenderThread(int threads);
+
+        // draw whole frames (RenderFrame) across threads cores, see BandRenderer
+        void StartBandRenderer(int threads);
 
-        u32 scanline_buffer[SCREEN_WIDTH];
-        u32 obj_scanline_buffer[SCREEN_WIDTH];
+        // frames are for sink (owned by the ppu from now on), see Presenter
+        // they are drawn in the sink's PixelFormat, so call this before StartRenderThread
+        void SetVideoSink(VideoSink *);
 
-        u32 screen_buffer[SCREEN_HEIGHT][SCREEN_WIDTH];
+        // where frames go, window events come from here too
+        VideoSink &Sink() { return *sink; }
 
-        // oam data structure
-        struct ObjAttr
+        /*
+         * Consumer side of the swap chain, safe to call from any one thread while the ppu
+         * runs on another: take the newest frame finished since the last call. The frame
+         * stays valid until the next call, and the ppu never waits on it (unless the sink is
+         * Lossless, then finishing a frame waits until the one before it is taken).
+         */
+        bool AcquireFrame(Frame &frame)
         {
-            // coordinate of top left (x0, y0) & origin 
-            int x,  y;
-            int x0, y0;
+            if (!frames.Acquire())
+                return false;
 
-            int obj_mode;     // 0 - normal render, 1 - affine, 2 - hidden, 3 - double-wide affine
-            int gfx_mode;     // 0 - normal, 1 - semi-transparent, 2 - obj window, 3 - illegal
-            int color_mode;   // 256 color if on, 16 color if off
-            bool mosaic;
+            frame = frames.Front();
+            return true;
+        }
 
-            int affine_index; // P matrix index (0 - 31)
-            bool h_flip;
-            bool v_flip;
+        // frame rate over the last 60 frames and lag frames so far, for showing on another thread
+        // returns how many times they were updated, once every 60 frames
+        u32 Stats(double &fps, u32 &lag) const
+        {
+            u32 count = stats_count.load(std::memory_order_acquire);
+
+            fps = stats_fps.load(std::memory_order_relaxed);
+            lag = stats_lag.load(std::memory_order_relaxed);
+
+            return count;
+        }
 
-            int tileno;       // base tile index of sprite
-            int priority;
-            int palbank;      // use in 16 color mode
+    private:
+        std::unique_ptr<VideoSink> sink;
+
+        bool draw; // this frame is drawn, see frameskip
 
-            int size;
-            int shape;
-            
-            // width, height of sprite in pixels (& half width, height)
-            int  width,  height;
-            int hwidth, hheight;
+        u8  frame; // counts 0 - 60
+        u64 frame_number; // since Reset, skipped frames included
+        u8 fps;
+        u64 old_time; // ns, FramePacer::Now
 
-            // affine matrix params
-            float pa;
-            float pb;
-            float pc;
-            float pd;
+        std::atomic<double> stats_fps{0};
+        std::atomic<u32>    stats_lag{0};
+        std::atomic<u32>    stats_count{0};
 
-        } objs[NUM_OBJS]; // can support 128 objects
+        // registers of every VDraw line, logged as the cpu reaches them
+        ScanlineLog lines;
 
-        // holds the indeces of which objs need to be displayed
-        std::unique_ptr<std::stack<int>> oam_update;
+        // draws lines from the log out of the live VRAM, palette and OAM caches in mem
+        Renderer renderer;
+
+        // drawing on another thread instead, NULL unless StartRenderThread was called
+        RenderThread *render_thread;
+
+        // whole frames drawn across cores, NULL unless StartBandRenderer was called
+        BandRenderer *bands;
+
+        // finished frames go from here to whichever thread presents them, see AcquireFrame
+        // the ppu draws into Back and publishes, or the render thread does both instead
+        TripleBuffer frames;
+
+        // bytes per row of a frame in the sink's format
+        int pitch;
 
         // video mode renders
-        void Render();
-        void RenderObj();
+        void Publish();
         void RenderScanline();
-        void RenderScanlineText(int);
-        void RenderScanlineAffine(int);
-        void RenderScanlineBitmap(int);
-
-        void DrawBackgroundReg(int);
-        void DrawBackgroundAffine(int);
-
-        // misc
-        u16 GetObjPixel4BPP(u32, int, int, int);
-        u16 GetObjPixel8BPP(u32, int, int);
-        u16 GetBGPixel4BPP(u32, int, int, int);
-        u16 GetBGPixel8BPP(u32, int, int);
-        void UpdateAttr();
+
+        // affine bg internal reference points
+        void LatchAffine();
+        void StepAffine();
 };
\ No newline at end of file
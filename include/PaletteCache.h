@@ -0,0 +1,94 @@
+/* discovery
+ * License: GPLv2
+ * See LICENSE.txt for full license text
+ *
+ * FILE: PaletteCache.h
+ * DATE: October 19th, 2026
+ * DESCRIPTION: palette RAM converted to host colors, refreshed from dirty bits
+ */
+
+#pragma once
+
+#include "common.h"
+#include "PixelFormat.h"
+
+/*
+ * All 512 palette entries (256 BG, 256 OBJ) are kept converted from BGR555 to the
+ * host color of the PixelFormat frames are drawn in. Memory::Write8 / Write8Unsafe mark an
+ * entry dirty when either of its bytes is written, and the ppu calls Refresh before
+ * drawing so only entries that changed get converted again. Mode 3 pixels come
+ * straight from VRAM, so they go through a table of every 15 bit color instead.
+ */
+class PaletteCache
+{
+    public:
+        static constexpr int NUM_COLORS = 512;
+
+        const u8 *pram; // &memory[MEM_PALETTE_RAM_START]
+
+        PaletteCache()
+        {
+            SetFormat(PixelFormat::XRGB8888);
+        }
+
+        // convert to format from now on, every entry is converted again on the next Refresh
+        void SetFormat(PixelFormat format)
+        {
+            this->format = format;
+
+            for (u32 color = 0; color < 0x8000; ++color)
+                direct[color] = EncodeColor(format, color);
+
+            InvalidateAll();
+        }
+
+        PixelFormat Format() const { return format; }
+
+        // a byte at palette RAM offset was written
+        inline void Invalidate(u32 offset)
+        {
+            u32 index = (offset & 0x3FF) >> 1;
+            dirty[index >> 6] |= 1ULL << (index & 63);
+        }
+
+        void InvalidateAll()
+        {
+            for (int i = 0; i < NUM_COLORS / 64; ++i)
+                dirty[i] = ~0ULL;
+        }
+
+        // convert the entries written since the last call
+        inline void Refresh()
+        {
+            for (int i = 0; i < NUM_COLORS / 64; ++i)
+            {
+                while (dirty[i])
+                {
+                    int index = i * 64 + __builtin_ctzll(dirty[i]);
+
+                    colors[index] = Direct(pram[index * 2] | pram[index * 2 + 1] << 8);
+                    dirty[i] &= dirty[i] - 1;
+                }
+            }
+        }
+
+        // host color of BG palette entry 0 - 255
+        inline u32 BG(int index) const { return colors[index]; }
+
+        // host color of OBJ palette entry 0 - 255
+        inline u32 OBJ(int index) const { return colors[256 + index]; }
+
+        // all 256 BG host colors, for Simd::GatherPalette
+        inline const u32 *BGColors() const { return colors; }
+
+        // host color of a 15 bit color (mode 3)
+        inline u32 Direct(u16 color) const { return direct[color & 0x7FFF]; }
+
+    private:
+        PixelFormat format;
+
+        u32 colors[NUM_COLORS];
+        u32 direct[0x8000];
+
+        u64 dirty[NUM_COLORS / 64];
+};
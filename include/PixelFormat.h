@@ -0,0 +1,101 @@
+/* discovery
+ * License: GPLv2
+ * See LICENSE.txt for full license text
+ *
+ * FILE: PixelFormat.h
+ * DATE: October 19th, 2026
+ * DESCRIPTION: pixel formats the ppu can draw frames in, chosen by the video sink
+ */
+
+#pragma once
+
+#include <string>
+
+#include "common.h"
+
+/*
+ * The palette cache holds every color already converted to the sink's format and the
+ * renderer composites and blends in it, so frames come out the way the sink wants them
+ * with no conversion pass. Each format keeps the gba's 5 significant bits of a channel
+ * at a fixed shift (the low bits are zero), which is all the blending needs.
+ */
+enum class PixelFormat
+{
+    XRGB8888, // 0x00RRGGBB, SDL's RGB888, the default
+    RGB565,   // 16 bit, embedded displays
+    BGRA8888, // bytes B, G, R, A in memory (0xAARRGGBB), alpha always 0xFF, capture APIs
+    BGR555,   // 16 bit, the gba's own colors untouched
+};
+
+template <PixelFormat> struct PixelTraits;
+
+template <> struct PixelTraits<PixelFormat::XRGB8888>
+{
+    using Pixel = u32;
+    static constexpr int R = 19, G = 11, B = 3;
+    static constexpr Pixel ALPHA = 0;
+    static constexpr Pixel WHITE = 0xFFFFFFFF; // forced blank
+};
+
+template <> struct PixelTraits<PixelFormat::RGB565>
+{
+    using Pixel = u16;
+    static constexpr int R = 11, G = 6, B = 0;
+    static constexpr Pixel ALPHA = 0;
+    static constexpr Pixel WHITE = 0xFFFF;
+};
+
+template <> struct PixelTraits<PixelFormat::BGRA8888>
+{
+    using Pixel = u32;
+    static constexpr int R = 19, G = 11, B = 3;
+    static constexpr Pixel ALPHA = 0xFF000000;
+    static constexpr Pixel WHITE = 0xFFFFFFFF;
+};
+
+template <> struct PixelTraits<PixelFormat::BGR555>
+{
+    using Pixel = u16;
+    static constexpr int R = 0, G = 5, B = 10;
+    static constexpr Pixel ALPHA = 0;
+    static constexpr Pixel WHITE = 0x7FFF;
+};
+
+inline int BytesPerPixel(PixelFormat format)
+{
+    return format == PixelFormat::RGB565 || format == PixelFormat::BGR555 ? 2 : 4;
+}
+
+// BGR555 color in format, without ALPHA (the renderer keeps layer attributes in the top byte)
+template <PixelFormat format>
+inline u32 EncodeColor(u16 color)
+{
+    using Traits = PixelTraits<format>;
+
+    return (color       & 0x1F) << Traits::R |
+           (color >>  5 & 0x1F) << Traits::G |
+           (color >> 10 & 0x1F) << Traits::B;
+}
+
+inline u32 EncodeColor(PixelFormat format, u16 color)
+{
+    switch (format)
+    {
+        case PixelFormat::RGB565:   return EncodeColor<PixelFormat::RGB565>(color);
+        case PixelFormat::BGRA8888: return EncodeColor<PixelFormat::BGRA8888>(color);
+        case PixelFormat::BGR555:   return EncodeColor<PixelFormat::BGR555>(color);
+        default:                    return EncodeColor<PixelFormat::XRGB8888>(color);
+    }
+}
+
+// xrgb8888, rgb565, bgra8888 or bgr555, false if name is none of those
+inline bool ParsePixelFormat(const std::string &name, PixelFormat &format)
+{
+    if      (name == "xrgb8888") format = PixelFormat::XRGB8888;
+    else if (name == "rgb565")   format = PixelFormat::RGB565;
+    else if (name == "bgra8888") format = PixelFormat::BGRA8888;
+    else if (name == "bgr555")   format = PixelFormat::BGR555;
+    else return false;
+
+    return true;
+}
@@ -0,0 +1,84 @@
+/* discovery
+ * License: GPLv2
+ * See LICENSE.txt for full license text
+ *
+ * FILE: PostProcess.h
+ * DATE: October 19th, 2026
+ * DESCRIPTION: filters finished frames for display - lcd color correction, ghosting and upscaling
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "Renderer.h"
+#include "ThreadPool.h"
+
+enum class Scaler
+{
+    None,    // 1x, the window scales
+    Nearest, // integer nearest neighbor, PostConfig::scale times
+    Scale2x, // EPX / AdvMAME2x
+    Scale3x, // AdvMAME3x
+    Xbr2x,   // 2xBR level 1
+};
+
+struct PostConfig
+{
+    Scaler scaler = Scaler::None;
+    int    scale  = 1; // Nearest only, the others have their own
+
+    bool lcd      = false; // gba lcd color response
+    bool ghosting = false; // blend each frame with the last one shown, like the lcd's slow pixels
+
+    int threads = 1;
+
+    bool Enabled() const { return scaler != Scaler::None || lcd || ghosting; }
+
+    // none, 2x - 8x (nearest), scale2x, scale3x or xbr, false if name is none of those
+    bool SetScaler(const std::string &name);
+};
+
+/*
+ * The filters run on a copy, in two passes: the color pass (lcd lut, ghosting) over the
+ * frame, then the scaler, which reads neighboring lines, over the color pass's output.
+ * Each pass is split into bands of lines on a ThreadPool. The frame the ppu drew is never
+ * written, so sinks that hash or record frames always get them exactly as drawn. Run is
+ * called by the sink on the presenting thread, so the filters never hold up emulation.
+ */
+class PostProcess
+{
+    public:
+        explicit PostProcess(const PostConfig &);
+
+        // size of the output
+        int Width()  const { return SCREEN_WIDTH  * factor; }
+        int Height() const { return SCREEN_HEIGHT * factor; }
+
+        // output depends on earlier frames (ghosting), so an unchanged frame still changes it
+        bool Temporal() const { return config.ghosting; }
+
+        // filter a SCREEN_HEIGHT x SCREEN_WIDTH frame into out, Height() rows pitch pixels apart
+        void Run(const u32 *frame, u32 *out, int pitch);
+
+    private:
+        static constexpr int BAND_LINES = 16;
+
+        PostConfig config;
+        int factor;
+
+        ThreadPool pool;
+
+        std::vector<u32> lut;    // lcd color for every rgb555 color
+        std::vector<u32> colors; // color pass output, and the last frame shown for ghosting
+        std::vector<u32> yuv;    // xbr, y << 16 | u << 8 | v of every pixel of colors
+
+        void Color(const u32 *frame, int line, u32 *out);
+        void Scale(const u32 *src, int line, u32 *out, int pitch);
+
+        void Scale3xLine(const u32 *src, int line, u32 *out, int pitch);
+        void Xbr2xLine(const u32 *src, int line, u32 *out, int pitch);
+
+        void BuildLcdLut();
+};
@@ -0,0 +1,55 @@
+/* discovery
+ * License: GPLv2
+ * See LICENSE.txt for full license text
+ *
+ * FILE: Presenter.h
+ * DATE: October 19th, 2026
+ * DESCRIPTION: takes finished frames from the ppu's swap chain and presents them, on a thread of its own
+ */
+
+#pragma once
+
+#include <string>
+#include <memory>
+
+#include "PPU.h"
+#include "FrameDamage.h"
+
+class ShmExport;
+
+/*
+ * The consumer end of the ppu's TripleBuffer. Present runs on the presenting thread (the
+ * main one, which owns the SDL window) while the cpu runs on another, so uploading,
+ * post-processing, vsync and shared memory copies never hold up emulation. It takes the
+ * newest frame the ppu finished, works out its damage against the last one presented,
+ * and hands it to the ppu's sink and to shared memory.
+ */
+class Presenter
+{
+    public:
+        explicit Presenter(PPU *);
+        ~Presenter();
+
+        // also publish every presented frame to shared memory object name, see ShmExport
+        // frames are in the sink's PixelFormat, so call this after PPU::SetVideoSink
+        void StartShmExport(const std::string &name);
+
+        // present the newest finished frame, false if there wasn't one since the last call
+        bool Present();
+
+    private:
+        PPU *ppu;
+
+        // presented frames for other processes, NULL unless StartShmExport was called
+        std::unique_ptr<ShmExport> shm;
+
+        // HashLine of every line of the last frame presented
+        u64 shown_hashes[SCREEN_HEIGHT];
+
+        // lines of the frame being presented that differ from the last one, repaint marks them all
+        FrameDamage damage;
+        bool repaint;
+
+        // PPU::Stats count last shown
+        u32 stats;
+};
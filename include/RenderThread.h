@@ -0,0 +1,98 @@
+/* discovery
+ * License: GPLv2
+ * See LICENSE.txt for full license text
+ *
+ * FILE: RenderThread.h
+ * DATE: October 19th, 2026
+ * DESCRIPTION: draws frames on a worker thread, pipelined one frame behind the cpu
+ */
+
+#pragma once
+
+#include <thread>
+#include <atomic>
+
+#include "BandRenderer.h"
+#include "SpscQueue.h"
+#include "TripleBuffer.h"
+
+/*
+ * At VBlank the ppu hands Queue the frame's ScanlineLog. Queue copies it into a free slot,
+ * along with the VideoWriteLog Memory recorded the frame's VRAM, palette RAM and OAM
+ * writes into, and queues it to the worker, which draws it into the back buffer of the
+ * ppu's swap chain and publishes it, taking over the producer side of the TripleBuffer
+ * from the ppu. The cpu only waits when every slot is still in flight.
+ *
+ * The worker keeps its own copy of video memory with its own decode caches, and replays
+ * each write into it just before the first line that sees it, so mid-frame writes land
+ * on the same lines as on the cycle ppu and register writes keep theirs through the
+ * ScanlineLog. A frame whose writes overflowed the log brings a snapshot of video memory
+ * as it is at VBlank instead, and is drawn from that; it's merged a block at a time and
+ * only blocks that differ are invalidated, so the caches stay as warm as the ppu's.
+ */
+class RenderThread
+{
+    public:
+        // threads > 1 splits each frame across that many cores, see BandRenderer
+        // frames are drawn in format and published to frames, lossless waits for the consumer instead of dropping frames
+        // mem's video memory writes are logged for the worker until the RenderThread is destroyed
+        RenderThread(Memory *mem, int threads, PixelFormat format, TripleBuffer *frames, bool lossless);
+        ~RenderThread();
+
+        // queue frame number n, keypad state keys, to be drawn and published
+        void Queue(const ScanlineLog &, u64 n, u16 keys);
+
+        // the frame just finished isn't drawn, its writes carry over to the next one queued
+        void Skip();
+
+    private:
+        static constexpr int NUM_SLOTS = 3; // being drawn, waiting to be drawn, being filled
+
+        struct Slot
+        {
+            ScanlineLog lines;
+            VideoWriteLog *writes;
+
+            // video memory at VBlank, only filled in when snapshot is set
+            bool snapshot;
+            u8 vram[0x18000];
+            u8 pram[MEM_PALETTE_RAM_SIZE];
+            u8 oam[MEM_OAM_SIZE];
+
+            u64 number;
+            u16 keys;
+        } slots[NUM_SLOTS];
+
+        Memory *mem;
+        TripleBuffer *frames; // worker side is the producer
+        bool lossless;
+
+        // one per slot, and the one Memory writes into, which Queue trades for the slot's
+        VideoWriteLog  logs[NUM_SLOTS + 1];
+        VideoWriteLog *recording;
+
+        SpscQueue<int, 4> pending; // cpu -> worker
+        SpscQueue<int, 4> done;    // worker -> cpu
+
+        // cpu side
+        int free_slots[NUM_SLOTS];
+        int num_free;
+
+        // worker side copy of video memory, and the caches the renderer draws from
+        u8 vram[0x18000];
+        u8 pram[MEM_PALETTE_RAM_SIZE];
+        u8 oam[MEM_OAM_SIZE];
+
+        TileCache    tiles;
+        PaletteCache palette;
+        OamCache     objs;
+        BandRenderer renderer;
+
+        std::atomic<bool> running;
+        std::thread worker;
+
+        void Run();
+        void Replay(const Slot &, void *screen, int pitch, u64 *hashes);
+        void Apply(const VideoWriteLog::Run &, const u8 *data);
+        void Merge(const Slot &);
+};
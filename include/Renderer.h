@@ -0,0 +1,98 @@
+/* discovery
+ * License: GPLv2
+ * See LICENSE.txt for full license text
+ *
+ * FILE: Renderer.h
+ * DATE: October 19th, 2026
+ * DESCRIPTION: draws scanlines from a ScanlineLog and the VRAM, palette and OAM caches
+ */
+
+#pragma once
+
+#include "common.h"
+#include "Memory.h"
+#include "ScanlineLog.h"
+
+constexpr int SCREEN_WIDTH        = 240;
+constexpr int SCREEN_HEIGHT       = 160;
+
+constexpr int CHARBLOCK_LEN       = 0x4000;
+constexpr int SCREENBLOCK_LEN     = 0x800;
+
+constexpr int PALBANK_LEN         = 32; // length of each of palette RAM's 16 banks in 4bpp mode (s-tiles)
+
+constexpr int NUM_OBJS            = 128; // number of sprites that can be rendered
+
+constexpr u32 LOWER_SPRITE_BLOCK  = 0x6010000;
+constexpr u32 HIGHER_SPRITE_BLOCK = 0x6014000;
+
+// layer ids, in WININ / BLDCNT bit order
+constexpr int LAYER_OBJ           = 4;
+constexpr int LAYER_BACKDROP      = 5;
+
+// attribute bits in the top byte of a line buffer pixel
+constexpr u32 LAYER_OPAQUE           = 1u << 31;
+constexpr u32 LAYER_SEMI_TRANSPARENT = 1u << 26; // OBJ gfx mode 1
+constexpr int LAYER_PRIORITY_SHIFT   = 24;       // 2 bits
+
+constexpr u32 BG_PALETTE          = 0x5000000;
+constexpr u32 SPRITE_PALETTE      = 0x5000200;
+
+/*
+ * Everything the ppu does to turn a scanline into pixels, with no timing or SDL in it.
+ * A renderer reads registers only from the log it is handed and memory only through
+ * the caches it was built with, so the ppu's renderer draws from the live caches in
+ * Memory while a RenderThread's draws from its own copy of a frame.
+ */
+class Renderer
+{
+    public:
+        Renderer(TileCache *, PaletteCache *, OamCache *);
+
+        void Reset();
+
+        // draw VDraw line of log into out (SCREEN_WIDTH pixels in the palette cache's PixelFormat)
+        // return its HashLine (see FrameDamage.h)
+        u64 DrawLine(const ScanlineLog &log, int line, void *out);
+
+        // draw every VDraw line of log into screen, whose rows are pitch bytes apart, and each line's hash into hashes
+        void DrawFrame(const ScanlineLog &log, void *screen, int pitch, u64 *hashes);
+
+    private:
+        TileCache    *tiles;
+        PaletteCache *palette;
+        OamCache     *objs;
+
+        // line being drawn and its snapshot
+        const ScanlineLog  *log;
+        const ScanlineRegs *regs;
+        int scanline;
+
+        // line buffers of BG0 - BG3 and OBJ for the current scanline, see Composite
+        // each pixel is a host color with the LAYER_* attribute bits in the top byte
+        u32  layers[5][SCREEN_WIDTH];
+        bool obj_window[SCREEN_WIDTH]; // covered by an OBJ window sprite
+        u8   layers_drawn;             // bit n set if layer n was rendered this scanline
+
+        // indices of the sprites in objs covering each scanline, in OAM order, see BinObjs
+        u8 obj_bins[SCREEN_HEIGHT][NUM_OBJS];
+        u8 obj_bin_count[SCREEN_HEIGHT];
+        u32 bins_generation; // OamCache::generation the bins were built from
+
+        // video mode renders
+        void RenderScanlineObj();
+        int  ObjTexel(int, int, int);
+        template <PixelFormat format>
+        u64 Composite(void *);
+        template <PixelFormat format>
+        u64 Fill(void *);
+        u32  BeginLayer(int);
+        void RenderScanlineText(int);
+        template <bool color_8bpp, int size>
+        void RenderScanlineText(int);
+        void RenderScanlineAffine(int);
+        void RenderScanlineBitmap(int);
+
+        // misc
+        void BinObjs();
+};
@@ -0,0 +1,124 @@
+/* discovery
+ * License: GPLv2
+ * See LICENSE.txt for full license text
+ *
+ * FILE: ScanlineLog.h
+ * DATE: October 19th, 2026
+ * DESCRIPTION: per scanline snapshots of the registers the ppu renders from
+ */
+
+#pragma once
+
+#include "common.h"
+#include "LcdStat.h"
+#include "mmio.h"
+
+constexpr int LOG_LINES = 160; // scanlines in VDraw
+
+// everything a scanline is rendered from, besides VRAM, palette RAM and OAM
+struct ScanlineRegs
+{
+    LcdStat::DisplayControl dispcnt;
+    LcdStat::BgControl      bgcnt[4];
+
+    // P matrix columns stepped per pixel on BG2, BG3 (pb and pd are folded into the reference points)
+    s16 pa[2];
+    s16 pc[2];
+
+    u16 winh[2];   // WIN0H, WIN1H
+    u16 winv[2];   // WIN0V, WIN1V
+    u16 winin;
+    u16 winout;
+    u16 bldcnt;
+    u16 bldalpha;
+    u16 bldy;
+};
+
+/*
+ * The ppu calls Record at every VDraw scanline, as the cpu timeline reaches it, and
+ * draws later from the log, so raster effects done with these registers come out the
+ * same no matter when (or how many lines at once) the drawing happens. VRAM, palette
+ * RAM and OAM aren't logged here: the cycle ppu drawing each line as it's reached sees
+ * them as they are then, and a RenderThread replays their writes the same way (see
+ * VideoWriteLog), but a whole frame drawn at VBlank (--fast) sees them as they are at
+ * VBlank. Memory::Write8 sets LcdStat::regs_dirty on writes to the display registers;
+ * while it stays clear, a line just points at the previous line's snapshot, and only
+ * the affine reference points, which move every line, are stored.
+ */
+class ScanlineLog
+{
+    public:
+        const u8 *io; // &memory[0x4000000]
+
+        ScanlineLog() : count(0) { }
+
+        // snapshot the registers for line, and clear stat.regs_dirty
+        inline void Record(int line, LcdStat &stat)
+        {
+            // a frame starts with a fresh snapshot
+            if (line == 0)
+                count = 0;
+
+            if (line == 0 || stat.regs_dirty)
+            {
+                Capture(regs[count], stat);
+                ++count;
+
+                stat.regs_dirty = false;
+            }
+
+            index[line] = count - 1;
+
+            for (int bg = 0; bg < 2; ++bg)
+            {
+                ref_x[line][bg] = stat.bgaffine[bg].ref_x;
+                ref_y[line][bg] = stat.bgaffine[bg].ref_y;
+            }
+        }
+
+        inline const ScanlineRegs &Regs(int line) const { return regs[index[line]]; }
+
+        // internal reference point of BG2 (bg 0) or BG3 (bg 1) at line
+        inline s32 RefX(int line, int bg) const { return ref_x[line][bg]; }
+        inline s32 RefY(int line, int bg) const { return ref_y[line][bg]; }
+
+        // distinct snapshots taken this frame
+        inline int Snapshots() const { return count; }
+
+    private:
+        ScanlineRegs regs[LOG_LINES]; // at most one new snapshot per line
+        u8  index[LOG_LINES];         // regs entry of each line
+        int count;
+
+        s32 ref_x[LOG_LINES][2];
+        s32 ref_y[LOG_LINES][2];
+
+        inline u16 Read16(u32 address) const
+        {
+            return io[address - REG_DISPCNT] | io[address - REG_DISPCNT + 1] << 8;
+        }
+
+        void Capture(ScanlineRegs &snapshot, const LcdStat &stat) const
+        {
+            snapshot.dispcnt = stat.dispcnt;
+
+            for (int bg = 0; bg < 4; ++bg)
+                snapshot.bgcnt[bg] = stat.bgcnt[bg];
+
+            for (int bg = 0; bg < 2; ++bg)
+            {
+                snapshot.pa[bg] = stat.bgaffine[bg].pa;
+                snapshot.pc[bg] = stat.bgaffine[bg].pc;
+            }
+
+            snapshot.winh[0]  = Read16(REG_WIN0H);
+            snapshot.winh[1]  = Read16(REG_WIN1H);
+            snapshot.winv[0]  = Read16(REG_WIN0V);
+            snapshot.winv[1]  = Read16(REG_WIN1V);
+            snapshot.winin    = Read16(REG_WININ);
+            snapshot.winout   = Read16(REG_WINOUT);
+            snapshot.bldcnt   = Read16(REG_BLDCNT);
+            snapshot.bldalpha = Read16(REG_BLDALPHA);
+            snapshot.bldy     = Read16(REG_BLDY);
+        }
+};
@@ -0,0 +1,88 @@
+/* discovery
+ * License: GPLv2
+ * See LICENSE.txt for full license text
+ *
+ * FILE: ShmExport.h
+ * DATE: October 19th, 2026
+ * DESCRIPTION: publishes presented frames to a POSIX shared memory ring for local tools
+ */
+
+#pragma once
+
+#include <atomic>
+#include <string>
+
+#include "Renderer.h"
+#include "PixelFormat.h"
+#include "FrameDamage.h"
+
+constexpr u32 SHM_MAGIC   = 0x4D524644; // "DFRM"
+constexpr u32 SHM_VERSION = 1;
+constexpr int SHM_SLOTS   = 4;
+
+/*
+ * Layout of the shared memory object, for readers in other processes (C or C++, same
+ * host). A ShmHeader, then SHM_SLOTS frames of height rows pitch bytes apart, slot n at
+ * frames_offset + n * frame_bytes from the start of the mapping.
+ *
+ * Every slot is a seqlock. The emulator makes sequence odd, writes the frame and its
+ * info, then makes it even again, and never waits on anyone. To read the newest frame:
+ * load published (acquire), take slot (published - 1) % slots, load its sequence
+ * (acquire), retry if odd, read the pixels and info in place, then load sequence again
+ * (after an acquire fence) and discard what was read if it changed. A slot is only
+ * rewritten every SHM_SLOTS frames, so a reader has that long before it gets torn.
+ */
+struct alignas(64) ShmSlot
+{
+    std::atomic<u32> sequence; // odd while being written, even when stable
+    u32 keys;                  // KEYINPUT when the frame was presented, bits 0 - 9, 0 = pressed
+    u64 frame;                 // ppu frame number it was presented at, skipped frames included
+    u8  dirty[SCREEN_HEIGHT];  // 1 for lines that changed since the frame published before it
+};
+
+struct alignas(64) ShmHeader
+{
+    u32 magic;   // SHM_MAGIC once the header is filled in
+    u32 version; // SHM_VERSION
+    u32 width, height;
+    u32 format;  // PixelFormat: 0 xrgb8888, 1 rgb565, 2 bgra8888, 3 bgr555
+    u32 pitch;   // bytes per row
+    u32 slots;   // SHM_SLOTS
+    u32 frame_bytes;
+    u64 frames_offset;
+
+    std::atomic<u64> published; // frames published so far
+
+    ShmSlot slot[SHM_SLOTS];
+};
+
+/*
+ * The emulator's side of the ring. Publish runs on the presenting thread with each frame
+ * taken from the ppu's swap chain, reading the swap chain's own memory (never a sink's);
+ * it copies only the lines whose hash differs from what the slot already holds, so a
+ * still picture costs the header writes and nothing more.
+ */
+class ShmExport
+{
+    public:
+        // create shared memory object name, LOGs and exits on failure or if it already exists
+        ShmExport(const std::string &name, PixelFormat);
+        ~ShmExport();
+
+        // a frame in the format given at creation, rows pitch bytes apart, with its line hashes and damage
+        void Publish(const void *pixels, int pitch, const u64 *hashes, const FrameDamage &, u64 frame, u16 keys);
+
+    private:
+        std::string name;
+        size_t size;
+
+        ShmHeader *header;
+        u8 *frames;
+        int line_bytes;
+
+        u64 published;
+
+        // HashLine of every line in each slot, and whether the slot holds a frame yet
+        u64  slot_hashes[SHM_SLOTS][SCREEN_HEIGHT];
+        bool filled[SHM_SLOTS];
+};
@@ -0,0 +1,54 @@
+/* discovery
+ * License: GPLv2
+ * See LICENSE.txt for full license text
+ *
+ * FILE: Simd.h
+ * DATE: October 19th, 2026
+ * DESCRIPTION: vectorized scanline kernels, picked for the host cpu at startup
+ */
+
+#pragma once
+
+#include <string>
+
+#include "common.h"
+
+namespace Simd
+{
+    // little endian BGR555 pixels to host colors (mode 3)
+    extern void (*ConvertBGR555)(const u8 *src, u32 *dst, int count);
+
+    // palette indices to host colors (modes 4 and 5)
+    extern void (*GatherPalette)(const u8 *src, const u32 *palette, u32 *dst, int count);
+
+    // palette indices (0 where transparent) of count pixels of an affine bg line, starting at
+    // 20.8 fixed point texture coordinate (x, y) and stepping by (pa, pc) per pixel
+    // map and tiles point at the bg's screen and character base blocks, size is the map size in pixels
+    extern void (*AffineLine)(const u8 *map, const u8 *tiles, int size, bool wrap,
+                              s32 x, s32 y, s32 pa, s32 pc, u8 *dst, int count);
+
+    // post-processing kernels, host colors in and out
+
+    // dst = lut[rgb555 of src], the lut has 32 x 32 x 32 entries indexed r << 10 | g << 5 | b
+    extern void (*ColorLut)(const u32 *src, const u32 *lut, u32 *dst, int count);
+
+    // dst = a and b averaged per channel, rounding toward a so repeated blends settle on a
+    extern void (*Average)(const u32 *a, const u32 *b, u32 *dst, int count);
+
+    // dst = y << 16 | u << 8 | v of each pixel, 8.8 fixed point BT.601 with u and v biased by 128 (xbr's color distance)
+    extern void (*RgbToYuv)(const u32 *src, u32 *dst, int count);
+
+    // each of count pixels repeated n times
+    extern void (*RepeatPixels)(const u32 *src, u32 *dst, int count, int n);
+
+    // one line of Scale2x: line and the lines above / below it (the line itself at the edges)
+    // to the two output lines, each 2 * width pixels
+    extern void (*Scale2xLine)(const u32 *above, const u32 *line, const u32 *below, u32 *out0, u32 *out1, int width);
+
+    // avx2, sse2 or scalar, whichever the kernels above were set to
+    extern const char *isa;
+
+    // point the kernels above at name's (avx2, sse2 or scalar), the widest the host supports is picked at startup
+    // return false, and leave them alone, if the host can't run name
+    bool Use(const std::string &name);
+}
@@ -0,0 +1,62 @@
+/* discovery
+ * License: GPLv2
+ * See LICENSE.txt for full license text
+ *
+ * FILE: SpscQueue.h
+ * DATE: October 19th, 2026
+ * DESCRIPTION: lock-free bounded queue for exactly one producer and one consumer thread
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+
+// N must be a power of 2. Push / Pop never block, they fail when the queue is full / empty;
+// a consumer with nothing else to do sleeps in WaitForItem until a Push.
+template <typename T, size_t N>
+class SpscQueue
+{
+    static_assert((N & (N - 1)) == 0, "SpscQueue size must be a power of 2");
+
+    public:
+        // producer only
+        bool Push(const T &item)
+        {
+            size_t t = tail.load(std::memory_order_relaxed);
+
+            if (t - head.load(std::memory_order_acquire) == N)
+                return false;
+
+            items[t & (N - 1)] = item;
+            tail.store(t + 1, std::memory_order_release);
+            tail.notify_one();
+            return true;
+        }
+
+        // consumer only
+        bool Pop(T &item)
+        {
+            size_t h = head.load(std::memory_order_relaxed);
+
+            if (h == tail.load(std::memory_order_acquire))
+                return false;
+
+            item = items[h & (N - 1)];
+            head.store(h + 1, std::memory_order_release);
+            return true;
+        }
+
+        // consumer only, block until the queue isn't empty
+        void WaitForItem()
+        {
+            tail.wait(head.load(std::memory_order_relaxed), std::memory_order_acquire);
+        }
+
+    private:
+        // head and tail on their own cache lines so the two threads don't share one
+        alignas(64) std::atomic<size_t> head{0};
+        alignas(64) std::atomic<size_t> tail{0};
+
+        T items[N];
+};
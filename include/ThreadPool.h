@@ -0,0 +1,64 @@
+/* discovery
+ * License: GPLv2
+ * See LICENSE.txt for full license text
+ *
+ * FILE: ThreadPool.h
+ * DATE: October 19th, 2026
+ * DESCRIPTION: fork-join pool that spreads numbered tasks over worker threads with work stealing
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "common.h"
+
+/*
+ * Run(n, task) deals tasks 0 - n-1 out in contiguous runs, one per thread (the caller
+ * is thread 0), and returns once every task has run. A thread takes tasks from the
+ * front of its own run and, when that is empty, steals from the back of the others',
+ * so a thread stuck on expensive tasks gets helped. Each run is a [begin, end) pair
+ * packed in one atomic word, which lets the owner and the thieves claim tasks with a
+ * single compare-and-swap and no locks.
+ */
+class ThreadPool
+{
+    public:
+        // threads counts the caller, so threads - 1 workers are started
+        explicit ThreadPool(int threads);
+        ~ThreadPool();
+
+        int Threads() const { return (int) runs.size(); }
+
+        // call task(index, thread) for index 0 - count-1 and wait for all of them
+        void Run(int count, const std::function<void(int, int)> &task);
+
+    private:
+        struct alignas(64) TaskRange
+        {
+            std::atomic<u64> range; // begin in the low 32 bits, end in the high 32
+        };
+
+        std::vector<TaskRange> runs;
+        std::vector<std::thread> workers;
+
+        // job handoff, workers sleep between frames
+        std::mutex mutex;
+        std::condition_variable wake;
+        u64 job;       // incremented for every Run
+        bool stopping;
+
+        const std::function<void(int, int)> *task;
+        std::atomic<int> remaining; // tasks not yet finished in the current job
+
+        void Work(int thread);
+        void Drain(int thread);
+
+        bool Take(int thread, int &index);
+        bool Steal(int victim, int &index);
+};
@@ -0,0 +1,160 @@
+/* discovery
+ * License: GPLv2
+ * See LICENSE.txt for full license text
+ *
+ * FILE: TileCache.h
+ * DATE: October 19th, 2026
+ * DESCRIPTION: tiles in VRAM decoded to palette indices, invalidated by VRAM writes
+ */
+
+#pragma once
+
+#include "common.h"
+
+/*
+ * Every 32 byte block of VRAM is the start of a 4bpp tile and of an 8bpp tile (BG 8bpp
+ * tiles are 64 byte aligned, OBJ 8bpp tiles need not be), so both are cached per block.
+ * Rows are decoded to one palette index per pixel the first time they're drawn after a
+ * write, and the horizontally flipped copy only when a flipped tile is drawn. Vertical
+ * flip is just a different row. Memory::Write8 / Write8Unsafe call Invalidate for every
+ * VRAM byte written, which covers both the cpu and DMA.
+ */
+class TileCache
+{
+    public:
+        static constexpr int NUM_BLOCKS = 0x18000 / 32;
+
+        // the block after the last one, VRAM 0x18000 - 0x1FFFF mirrors 0x10000 - 0x17FFF
+        static constexpr int WRAP_BLOCK = 0x10000 / 32;
+
+        const u8 *vram; // &memory[MEM_VRAM_START]
+
+        TileCache() { InvalidateAll(); }
+
+        // a byte at vram offset was written
+        inline void Invalidate(u32 offset)
+        {
+            u32 block = Block(offset);
+
+            Mark(dirty_4bpp, block);
+            Mark(dirty_8bpp, block);
+
+            // the 8bpp tile starting one block earlier covers this one too
+            if (block != 0)
+                Mark(dirty_8bpp, block - 1);
+
+            // and the last block's wraps around to the start of the mirrored 32K, see Decode8BPP
+            if (block == WRAP_BLOCK)
+                Mark(dirty_8bpp, NUM_BLOCKS - 1);
+        }
+
+        void InvalidateAll()
+        {
+            for (int i = 0; i < NUM_BLOCKS / 64; ++i)
+            {
+                dirty_4bpp[0][i] = dirty_4bpp[1][i] = ~0ULL;
+                dirty_8bpp[0][i] = dirty_8bpp[1][i] = ~0ULL;
+            }
+        }
+
+        // decode every stale tile now, so Row4BPP / Row8BPP only read and can be called from several threads
+        void Refresh()
+        {
+            for (int hflip = 0; hflip < 2; ++hflip)
+            {
+                for (int i = 0; i < NUM_BLOCKS / 64; ++i)
+                {
+                    while (dirty_4bpp[hflip][i])
+                        Decode4BPP(i * 64 + __builtin_ctzll(dirty_4bpp[hflip][i]), hflip);
+
+                    while (dirty_8bpp[hflip][i])
+                        Decode8BPP(i * 64 + __builtin_ctzll(dirty_8bpp[hflip][i]), hflip);
+                }
+            }
+        }
+
+        // 8 palette indices (0 - 15) of row y of the 4bpp tile at vram offset, mirrored if hflip
+        inline const u8 *Row4BPP(u32 offset, int y, bool hflip)
+        {
+            u32 block = Block(offset);
+
+            if (Dirty(dirty_4bpp[hflip], block))
+                Decode4BPP(block, hflip);
+
+            return tiles_4bpp[block][hflip][y];
+        }
+
+        // 8 palette indices (0 - 255) of row y of the 8bpp tile at vram offset, mirrored if hflip
+        inline const u8 *Row8BPP(u32 offset, int y, bool hflip)
+        {
+            u32 block = Block(offset);
+
+            if (Dirty(dirty_8bpp[hflip], block))
+                Decode8BPP(block, hflip);
+
+            return tiles_8bpp[block][hflip][y];
+        }
+
+    private:
+        u8 tiles_4bpp[NUM_BLOCKS][2][8][8]; // [block][hflip][y][x]
+        u8 tiles_8bpp[NUM_BLOCKS][2][8][8];
+
+        // one bit per block, set when the decoded copy is stale
+        u64 dirty_4bpp[2][NUM_BLOCKS / 64];
+        u64 dirty_8bpp[2][NUM_BLOCKS / 64];
+
+        // 0x6018000 - 0x601FFFF mirrors 0x6010000 - 0x6017FFF, same as Memory::Read8
+        static inline u32 Block(u32 offset)
+        {
+            offset &= 0x1FFFF;
+
+            if (offset >= 0x18000)
+                offset -= 0x8000;
+
+            return offset >> 5;
+        }
+
+        static inline bool Dirty(const u64 *bitmap, u32 block)
+        {
+            return bitmap[block >> 6] >> (block & 63) & 1;
+        }
+
+        static inline void Mark(u64 (&bitmaps)[2][NUM_BLOCKS / 64], u32 block)
+        {
+            bitmaps[0][block >> 6] |= 1ULL << (block & 63);
+            bitmaps[1][block >> 6] |= 1ULL << (block & 63);
+        }
+
+        void Decode4BPP(u32 block, bool hflip)
+        {
+            const u8 *data = vram + block * 32;
+
+            for (int y = 0; y < 8; ++y)
+            {
+                for (int x = 0; x < 8; ++x)
+                {
+                    // low nybble is the left pixel of each pair
+                    u8 index = data[y * 4 + x / 2] >> (x & 1 ? 4 : 0) & 0xF;
+                    tiles_4bpp[block][hflip][y][hflip ? 7 - x : x] = index;
+                }
+            }
+
+            dirty_4bpp[hflip][block >> 6] &= ~(1ULL << (block & 63));
+        }
+
+        void Decode8BPP(u32 block, bool hflip)
+        {
+            // rows 0 - 3 are in this block and 4 - 7 in the next, which for the last block wraps like the hardware's
+            const u8 *halves[2] = { vram + block * 32, vram + (block == NUM_BLOCKS - 1 ? WRAP_BLOCK : block + 1) * 32 };
+
+            for (int y = 0; y < 8; ++y)
+            {
+                const u8 *row = halves[y >> 2] + (y & 3) * 8;
+
+                for (int x = 0; x < 8; ++x)
+                    tiles_8bpp[block][hflip][y][hflip ? 7 - x : x] = row[x];
+            }
+
+            dirty_8bpp[hflip][block >> 6] &= ~(1ULL << (block & 63));
+        }
+};
@@ -0,0 +1,101 @@
+/* discovery
+ * License: GPLv2
+ * See LICENSE.txt for full license text
+ *
+ * FILE: TripleBuffer.h
+ * DATE: October 19th, 2026
+ * DESCRIPTION: lock-free triple buffered swap chain of frames, one producer and one consumer thread
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstring>
+
+#include "Renderer.h"
+
+// a finished frame as the consumer sees it
+struct Frame
+{
+    const void *pixels; // SCREEN_HEIGHT rows of SCREEN_WIDTH pixels in the sink's PixelFormat, packed
+    const u64  *hashes; // HashLine of every row, see FrameDamage.h
+    u64 number;         // ppu frame number, skipped frames included
+    u16 keys;           // KEYINPUT when the frame was finished
+};
+
+/*
+ * Three frames: back (producer's, being drawn), front (consumer's, being read) and the
+ * one in between, the newest finished frame. Publish swaps back with the middle one and
+ * Acquire swaps front with it, each with one atomic exchange of an index, so neither
+ * side ever waits on the other, the consumer never sees a frame being drawn, and a slow
+ * consumer just skips frames. A flag packed in with the middle index says whether it
+ * holds a frame the consumer hasn't taken yet; a producer that mustn't skip any sleeps
+ * in WaitTaken until Acquire clears it.
+ *
+ * Each buffer has room for a frame in the widest PixelFormat, narrower ones use the front of it.
+ */
+class TripleBuffer
+{
+    public:
+        TripleBuffer()
+        {
+            std::memset(buffers, 0, sizeof(buffers));
+            std::memset(hashes,  0, sizeof(hashes));
+            std::memset(numbers, 0, sizeof(numbers));
+            std::memset(keys,    0, sizeof(keys));
+        }
+
+        // producer only, the frame being drawn and its line hashes
+        void *Back() { return buffers[back]; }
+        u64 *BackHashes() { return hashes[back]; }
+
+        // producer only, Back becomes the newest frame (frame number n, keypad state k) and a free buffer the new Back
+        void Publish(u64 n, u16 k)
+        {
+            numbers[back] = n;
+            keys[back]    = k;
+            back = middle.exchange(back | FRESH, std::memory_order_acq_rel) & INDEX;
+        }
+
+        // producer only, true while the last frame published hasn't been taken, so the next Publish would drop it
+        bool Pending() const { return middle.load(std::memory_order_acquire) & FRESH; }
+
+        // producer only, block until the last frame published has been taken
+        void WaitTaken()
+        {
+            u32 m;
+
+            while ((m = middle.load(std::memory_order_acquire)) & FRESH)
+                middle.wait(m, std::memory_order_acquire);
+        }
+
+        // consumer only, take the newest frame if one was published since the last call
+        // return true if Front changed
+        bool Acquire()
+        {
+            if ((middle.load(std::memory_order_relaxed) & FRESH) == 0)
+                return false;
+
+            front = middle.exchange(front, std::memory_order_acq_rel) & INDEX;
+            middle.notify_one();
+            return true;
+        }
+
+        // consumer only, the frame taken by the last Acquire, valid until the next one
+        Frame Front() const { return { buffers[front], hashes[front], numbers[front], keys[front] }; }
+
+    private:
+        static constexpr u32 INDEX = 3;
+        static constexpr u32 FRESH = 4;
+
+        alignas(64) u32 buffers[3][SCREEN_HEIGHT][SCREEN_WIDTH];
+        u64 hashes[3][SCREEN_HEIGHT];
+
+        // written by the producer before publishing
+        u64 numbers[3];
+        u16 keys[3];
+
+        alignas(64) int back = 0;              // producer side
+        alignas(64) int front = 1;             // consumer side
+        alignas(64) std::atomic<u32> middle{2};
+};
@@ -20,6 +20,11 @@ namespace Util
     // determine which type of thumb operation an instruction is
     ThumbInstruction GetInstructionFormat(u16 instruction);
 
+    // GetInstructionFormat results for every encoding, built once at startup
+    // arm is indexed by bits 27-20 and 7-4, thumb by bits 15-8
+    extern u8 arm_decode_table[0x1000];
+    extern u8 thumb_decode_table[0x100];
+
     bool PathExists(std::string);
 
     // util inline functions
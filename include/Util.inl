@@ -7,6 +7,22 @@
  * ex: bitseq<7, 4>(0b11110000) = 0b1111
  */
 
+// table driven equivalent of GetInstructionFormat(u32)
+inline ArmInstruction DecodeArm(u32 instruction)
+{
+	// BEX is the only format that depends on bits 19-8
+	if ((instruction & 0x0FFFFFF0) == 0x012FFF10)
+		return ArmInstruction::BEX;
+
+	return (ArmInstruction) arm_decode_table[(instruction >> 16 & 0xFF0) | (instruction >> 4 & 0xF)];
+}
+
+// table driven equivalent of GetInstructionFormat(u16)
+inline ThumbInstruction DecodeThumb(u16 instruction)
+{
+	return (ThumbInstruction) thumb_decode_table[instruction >> 8];
+}
+
 template <int end, int start>
 inline u32 bitseq(u32 val)
 {
@@ -0,0 +1,129 @@
+/* discovery
+ * License: GPLv2
+ * See LICENSE.txt for full license text
+ *
+ * FILE: VideoSink.h
+ * DATE: October 19th, 2026
+ * DESCRIPTION: where the ppu's finished frames go - an SDL window, nowhere, a file or memory
+ */
+
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <cstdio>
+#include <string>
+#include <memory>
+
+#include "Renderer.h"
+#include "PostProcess.h"
+#include "FrameDamage.h"
+#include "PixelFormat.h"
+
+/*
+ * The Presenter hands every frame it takes from the ppu's swap chain to a sink, on the
+ * presenting thread (the main one, where SDL lives), never the emulation thread. Frames
+ * are SCREEN_HEIGHT x SCREEN_WIDTH pixels in the sink's PixelFormat, rows packed, and
+ * only valid during the call (the swap chain reuses its buffers), so a sink copies
+ * whatever it keeps. Only SdlSink touches SDL, so every other sink runs on hosts
+ * without a display.
+ *
+ * Every frame comes with its FrameDamage against the last frame presented, so a sink can
+ * skip a frame that didn't change and copy only the lines of one that partly did.
+ */
+class VideoSink
+{
+    public:
+        explicit VideoSink(PixelFormat format = PixelFormat::XRGB8888) : format(format) { }
+        virtual ~VideoSink() { }
+
+        // what the ppu draws frames in for this sink, fixed for its lifetime
+        PixelFormat Format() const { return format; }
+
+        virtual void Present(const void *pixels, const FrameDamage &) = 0;
+
+        // true if the sink must get every frame drawn, the ppu then waits for the presenter
+        // rather than replace a frame it hasn't taken yet
+        virtual bool Lossless() const { return false; }
+
+        // once a second, frame rate over the last 60 frames
+        virtual void ShowStats(double fps, u32 lag_frames) { }
+
+        // next pending window / keyboard event, false if there isn't one (or no window)
+        virtual bool PollEvent(SDL_Event &) { return false; }
+
+    protected:
+        PixelFormat format;
+
+        // bytes in a line of a frame
+        int LineBytes() const { return SCREEN_WIDTH * BytesPerPixel(format); }
+};
+
+// the window, frames are uploaded into a streaming texture and scaled to fit by SDL_Renderer
+// with post-processing, frames are filtered into the texture instead (the filters work on xrgb8888 frames only)
+// unchanged frames aren't presented at all, and only the dirty lines of the others are uploaded
+class SdlSink : public VideoSink
+{
+    public:
+        SdlSink(const PostConfig &, PixelFormat);
+        ~SdlSink();
+
+        void Present(const void *, const FrameDamage &) override;
+        void ShowStats(double, u32) override;
+        bool PollEvent(SDL_Event &) override;
+
+    private:
+        SDL_Window   *window;
+        SDL_Renderer *renderer;
+        SDL_Texture  *texture;
+
+        std::unique_ptr<PostProcess> post; // NULL if there are no filters
+
+        bool repaint; // the window was exposed or resized, present the next frame whatever its damage
+};
+
+// drops every frame (still drawn in format, for --shm)
+class NullSink : public VideoSink
+{
+    public:
+        explicit NullSink(PixelFormat format = PixelFormat::XRGB8888) : VideoSink(format) { }
+
+        void Present(const void *, const FrameDamage &) override { }
+};
+
+// appends every frame to a file as raw pixels, SCREEN_WIDTH * SCREEN_HEIGHT * BytesPerPixel bytes each
+// unchanged frames too, the file has one frame per frame presented
+class FileSink : public VideoSink
+{
+    public:
+        FileSink(const std::string &path, PixelFormat);
+        ~FileSink();
+
+        void Present(const void *, const FrameDamage &) override;
+        bool Lossless() const override { return true; }
+
+    private:
+        std::FILE *file;
+};
+
+// keeps the latest frame, in its own screen or a buffer the caller owns, copying in only dirty lines
+class MemorySink : public VideoSink
+{
+    public:
+        explicit MemorySink(PixelFormat format = PixelFormat::XRGB8888)
+            : VideoSink(format), buffer((u8 *) screen), pitch(LineBytes()), frames(0) { }
+
+        MemorySink(void *buffer, int pitch, PixelFormat format = PixelFormat::XRGB8888)
+            : VideoSink(format), buffer((u8 *) buffer), pitch(pitch), frames(0) { }
+
+        u32 screen[SCREEN_HEIGHT][SCREEN_WIDTH]; // room for the widest format, narrower ones pack their rows
+
+        u8  *buffer; // latest frame, rows pitch bytes apart
+        int  pitch;
+        u64  frames; // presented so far
+
+        void Present(const void *, const FrameDamage &) override;
+};
+
+// sdl, null, memory or file:<path>, LOGs and exits on anything else
+// post-processing is for display, only the sdl sink applies it, and in xrgb8888 only
+VideoSink *MakeVideoSink(const std::string &name, const PostConfig &post, PixelFormat format);
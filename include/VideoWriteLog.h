@@ -0,0 +1,108 @@
+/* discovery
+ * License: GPLv2
+ * See LICENSE.txt for full license text
+ *
+ * FILE: VideoWriteLog.h
+ * DATE: October 19th, 2026
+ * DESCRIPTION: journal of VRAM, palette RAM and OAM writes tagged with the scanline that first sees them
+ */
+
+#pragma once
+
+#include "common.h"
+#include "LcdStat.h"
+#include "ScanlineLog.h"
+
+/*
+ * What ScanlineLog is for the display registers, this is for video memory. While a
+ * RenderThread is attached, Memory::Write8 / Write8Unsafe hand every byte written to
+ * VRAM, palette RAM or OAM to Write, which tags it with the first line drawn after it:
+ * the cycle ppu draws a line at the start of its HBlank, so a write during line n's
+ * HDraw is seen by n and one during its HBlank by n + 1. VBlank writes come before line
+ * 0 of the next frame, and a tag of LOG_LINES means after the last line.
+ *
+ * Writes are stored as runs of contiguous bytes with the same tag, so a DMA or memcpy
+ * costs one run. The worker replays them between the lines it draws. When a frame
+ * writes more than fits, the log says so and the worker falls back to a snapshot.
+ */
+class VideoWriteLog
+{
+    public:
+        static constexpr u32 MAX_RUNS  = 4096;
+        static constexpr u32 MAX_BYTES = 0x20000;
+
+        struct Run
+        {
+            u32 address; // first byte written, 0x5000000 - 0x70003FF
+            u32 data;    // offset of its bytes in Data
+            u32 length;
+            u32 line;    // first line that sees it, 0 - LOG_LINES
+        };
+
+        VideoWriteLog() { Clear(); }
+
+        // value was written at address (already mirrored into its region) while the ppu was at stat
+        inline void Write(u32 address, u8 value, const LcdStat &stat)
+        {
+            if (overflowed)
+                return;
+
+            u32 line = stat.displaystat.in_vBlank ? 0 : stat.scanline + stat.displaystat.in_hBlank;
+            if (line > LOG_LINES)
+                line = LOG_LINES;
+
+            if (num_bytes == MAX_BYTES)
+            {
+                overflowed = true;
+                return;
+            }
+
+            Run *last = num_runs != 0 ? &runs[num_runs - 1] : NULL;
+
+            if (last == NULL || last->line != line || last->address + last->length != address)
+            {
+                if (num_runs == MAX_RUNS)
+                {
+                    overflowed = true;
+                    return;
+                }
+
+                last = &runs[num_runs++];
+                *last = { address, num_bytes, 0, line };
+            }
+
+            bytes[num_bytes++] = value;
+            last->length++;
+        }
+
+        // forget everything written so far
+        inline void Clear()
+        {
+            num_runs   = 0;
+            num_bytes  = 0;
+            overflowed = false;
+        }
+
+        // the frame written so far isn't drawn, everything in it comes before line 0 of the next one
+        inline void Settle()
+        {
+            for (u32 i = 0; i < num_runs; ++i)
+                runs[i].line = 0;
+        }
+
+        // more was written than fits, and some writes are missing
+        inline bool Overflowed() const { return overflowed; }
+
+        // in the order written, so tags never go down
+        inline const Run *Runs() const { return runs; }
+        inline u32 NumRuns() const { return num_runs; }
+        inline const u8 *Data() const { return bytes; }
+
+    private:
+        Run runs[MAX_RUNS];
+        u8  bytes[MAX_BYTES];
+
+        u32  num_runs;
+        u32  num_bytes;
+        bool overflowed;
+};
@@ -17,4 +17,43 @@ namespace config
     bool show_help = false;
 
     bool debug = false;
+
+    // run the fast core (AccuracyFast) instead of the cycle accurate one
+    bool fast = false;
+
+    // draw frames on a worker thread one frame behind the cpu, see RenderThread
+    bool render_thread = false;
+
+    // cores to draw each whole frame on (--fast or render_thread), see BandRenderer
+    int render_jobs = 1;
+
+    // frames not drawn, empty to draw all of them, see Discovery::ParseFrameSkip
+    std::string frameskip = "";
+
+    // run uncapped, drawing at most one frame per host refresh (Tab toggles it)
+    bool turbo = false;
+
+    // hold emulation to the GBA's refresh rate, see FramePacer
+    bool limit = true;
+
+    // where frames go, see MakeVideoSink: sdl, null, memory or file:<path>
+    std::string video = "sdl";
+
+    // what frames are drawn in, see PixelFormat
+    std::string pixel_format = "xrgb8888";
+
+    // shared memory object frames are also published to, empty for none, see ShmExport
+    std::string shm = "";
+
+    // post-processing of the sdl window's picture, see PostProcess
+    std::string scaler = "none";
+    bool lcd = false;
+    bool ghosting = false;
+    int post_jobs = 1;
+
+    // cpu clock multiplier, 0 if not given on the command line (falls back to game_config_name, then 1x)
+    double overclock = 0;
+
+    // per game settings, one line per game: <4 letter game code> overclock=<multiplier>
+    std::string game_config_name = "games.cfg";
 }
\ No newline at end of file
@@ -54,6 +54,10 @@ constexpr u32 REG_WINOUT   = 0x400004A;
 
 constexpr u32 REG_MOSAIC   = 0x400004C;
 
+constexpr u32 REG_BLDCNT   = 0x4000050;
+constexpr u32 REG_BLDALPHA = 0x4000052;
+constexpr u32 REG_BLDY     = 0x4000054;
+
 // Sound registers
 
 // DMA Transfer Channels
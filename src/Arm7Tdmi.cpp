@@ -17,7 +17,8 @@
 
 //#define PRINT
 
-Arm7Tdmi::Arm7Tdmi(Memory *mem) : mem(mem)
+template <typename Accuracy>
+Arm7Tdmi<Accuracy>::Arm7Tdmi(Memory *mem) : mem(mem)
 {
     registers = {0}; // zero out registers
     registers.r15 = 0x8000000; // starting address of gamepak flash rom
@@ -35,6 +36,9 @@ Arm7Tdmi::Arm7Tdmi(Memory *mem) : mem(mem)
 
     pipeline_full = false;
     cycles = 0;
+    clock_multiplier = 0x100;
+    cycle_fraction = 0;
+    decoded = 0;
     current_interrupt = 0;
     in_interrupt  = false;
     swi_vblank_intr = false;
@@ -48,9 +52,11 @@ Arm7Tdmi::Arm7Tdmi(Memory *mem) : mem(mem)
     #endif
 }
 
-Arm7Tdmi::~Arm7Tdmi() { }
+template <typename Accuracy>
+Arm7Tdmi<Accuracy>::~Arm7Tdmi() { }
 
-Mode Arm7Tdmi::GetMode()
+template <typename Accuracy>
+Mode Arm7Tdmi<Accuracy>::GetMode()
 {
     switch (registers.cpsr.flags.mode)
     {
@@ -67,7 +73,8 @@ Mode Arm7Tdmi::GetMode()
     } 
 }
 
-void Arm7Tdmi::SetMode(Mode mode)
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::SetMode(Mode mode)
 {
     bool valid = false;
 
@@ -95,7 +102,8 @@ void Arm7Tdmi::SetMode(Mode mode)
     }
 }
 
-u8 Arm7Tdmi::GetConditionCodeFlag(ConditionFlag flag)
+template <typename Accuracy>
+u8 Arm7Tdmi<Accuracy>::GetConditionCodeFlag(ConditionFlag flag)
 {
     switch (flag)
     {
@@ -109,7 +117,8 @@ u8 Arm7Tdmi::GetConditionCodeFlag(ConditionFlag flag)
     }
 }
 
-void Arm7Tdmi::SetConditionCodeFlag(ConditionFlag flag, u8 bit)
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::SetConditionCodeFlag(ConditionFlag flag, u8 bit)
 {
     // bit can only be 0 or 1
     if (bit > 1)
@@ -131,7 +140,8 @@ void Arm7Tdmi::SetConditionCodeFlag(ConditionFlag flag, u8 bit)
 }
 
 // determine if the condition field of an instruction is true, given the state of the CPSR
-bool Arm7Tdmi::ConditionMet(Condition condition)
+template <typename Accuracy>
+bool Arm7Tdmi<Accuracy>::ConditionMet(Condition condition)
 {
     switch (condition)
     {
@@ -156,7 +166,8 @@ bool Arm7Tdmi::ConditionMet(Condition condition)
     }
 }
 
-void Arm7Tdmi::Fetch()
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::Fetch()
 {
     if (!pipeline_full)
     {
@@ -190,9 +201,18 @@ void Arm7Tdmi::Fetch()
     }
 }
 
-void Arm7Tdmi::Decode(u32 instruction) { }
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::Decode(u32 instruction)
+{
+    switch (GetState())
+    {
+        case State::ARM:   decoded = (u8) Util::DecodeArm(instruction);         break;
+        case State::THUMB: decoded = (u8) Util::DecodeThumb((u16) instruction); break;
+    }
+}
 
-void Arm7Tdmi::Execute(u32 instruction)
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::Execute(u32 instruction)
 {  
     #ifdef PRINT
     std::cout << "Executing: " << std::hex << instruction << "\n";
@@ -210,52 +230,11 @@ void Arm7Tdmi::Execute(u32 instruction)
                 return;
             }
             
-            switch(Util::GetInstructionFormat(instruction))
-            {
-                case ArmInstruction::BEX:  BranchExchange(instruction);       break;
-                case ArmInstruction::B:    BranchLink(instruction);           break;
-                case ArmInstruction::DP:   DataProcessing(instruction);       break;
-                case ArmInstruction::MUL:  Multiply(instruction);             break;
-                case ArmInstruction::MULL: MultiplyLong(instruction);         break;
-                case ArmInstruction::PSR:  PSRTransfer(instruction);          break;
-                case ArmInstruction::SDT:  SingleDataTransfer(instruction);   break;
-                case ArmInstruction::HDT:  HalfwordDataTransfer(instruction); break;
-                case ArmInstruction::BDT:  BlockDataTransfer(instruction);    break;
-                case ArmInstruction::SWP:  SingleDataSwap(instruction);       break;
-                case ArmInstruction::INT:  SoftwareInterruptArm(instruction); break;
-                default:
-                    LOG(LogLevel::Error, "Cannot execute instruction {}, pc {}\n", instruction, registers.r15);
-                    registers.r15 &= ~0x3;
-            }
+            ExecuteArm(instruction, (ArmInstruction) decoded);
             break;
 
         case State::THUMB:
-            u16 instr = (u16) instruction;
-            switch(Util::GetInstructionFormat((u16) instruction))
-            {
-                case ThumbInstruction::MSR:    MoveShiftedRegister(instr);     break;
-                case ThumbInstruction::ADDSUB: AddSubtract(instr);             break;
-                case ThumbInstruction::IMM:    MoveImmediate(instr);           break;
-                case ThumbInstruction::ALU:    AluThumb(instr);                break;
-                case ThumbInstruction::HI:     HiRegisterOps(instr);           break;
-                case ThumbInstruction::PC:     PcRelLoad(instr);               break;
-                case ThumbInstruction::MOV:    LoadStoreRegOffset(instr);      break;
-                case ThumbInstruction::MOVS:   LoadStoreSignedHalfword(instr); break;
-                case ThumbInstruction::MOVI:   LoadStoreImmediate(instr);      break;
-                case ThumbInstruction::MOVH:   LoadStoreHalfword(instr);       break;
-                case ThumbInstruction::SP:     SpRelLoadStore(instr);          break;
-                case ThumbInstruction::LDA:    LoadAddress(instr);             break;
-                case ThumbInstruction::ADDSP:  AddOffsetToSp(instr);           break;
-                case ThumbInstruction::POP:    PushPop(instr);                 break;
-                case ThumbInstruction::MOVM:   MultipleLoadStore(instr);       break;
-                case ThumbInstruction::B:      ConditionalBranch(instr);       break;
-                case ThumbInstruction::SWI:    SoftwareInterruptThumb(instr);  break;
-                case ThumbInstruction::BAL:    UnconditionalBranch(instr);     break;
-                case ThumbInstruction::BL:     LongBranchLink(instr);          break;
-                default:
-                    std::cerr << "Cannot execute thumb instruction: " << (u16) instruction << " " << std::hex << registers.r15 << "\n";
-                    registers.r15 &= ~0x1;
-            }
+            ExecuteThumb((u16) instruction, (ThumbInstruction) decoded);
             break;
     }
 
@@ -299,7 +278,181 @@ void Arm7Tdmi::Execute(u32 instruction)
     #endif
 }
 
-u32 Arm7Tdmi::GetRegister(u32 reg)
+#ifdef THREADED_DISPATCH
+/*
+ * Threaded code version of Execute, built with `make DISPATCH=threaded`.
+ * Instead of returning to one central switch, every handler label ends with its own
+ * copy of NEXT, which retires the instruction, fetches and decodes the next one and
+ * jumps straight to its label. This spreads the indirect branch over one site per
+ * handler, so the predictor learns which handler tends to follow which.
+ */
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::Run(bool &running, void (*catch_up)(void *, u32), void *ctx)
+{
+    // indexed by ArmInstruction
+    static void *const arm_handlers[] =
+    {
+        &&arm_dp,    &&arm_psr, &&arm_mul, &&arm_mull, &&arm_swp,
+        &&arm_bex,   &&arm_hdt, &&arm_sdt, &&arm_undef, &&arm_bdt,
+        &&arm_b,     &&arm_undef, &&arm_undef, &&arm_undef, &&arm_int,
+    };
+
+    // indexed by ThumbInstruction
+    static void *const thumb_handlers[] =
+    {
+        &&thumb_msr,  &&thumb_addsub, &&thumb_imm,  &&thumb_alu,   &&thumb_hi,
+        &&thumb_pc,   &&thumb_mov,    &&thumb_movs, &&thumb_movi,  &&thumb_movh,
+        &&thumb_sp,   &&thumb_lda,    &&thumb_addsp, &&thumb_pop,  &&thumb_movm,
+        &&thumb_b,    &&thumb_swi,    &&thumb_bal,  &&thumb_bl,    &&thumb_und,
+    };
+
+    u32 instruction;
+
+    // fetch + decode the next instruction and jump to its handler
+    #define DISPATCH()                                                              \
+        do                                                                          \
+        {                                                                           \
+            if (!running)                                                           \
+                return;                                                             \
+            Fetch();                                                                \
+            instruction = pipeline[0];                                              \
+            Decode(instruction);                                                    \
+            if (GetState() == State::THUMB)                                         \
+                goto *thumb_handlers[decoded];                                      \
+            if (!ConditionMet((Condition) Util::bitseq<31, 28>(instruction)))       \
+                goto arm_skip;                                                      \
+            goto *arm_handlers[decoded];                                            \
+        } while (0)
+
+    // same bookkeeping Discovery::Run does between instructions
+    #define RETIRE()                                                                \
+        do                                                                          \
+        {                                                                           \
+            HandleInterrupt();                                                      \
+            pipeline[0] = pipeline[1];                                              \
+            pipeline[1] = pipeline[2];                                              \
+            catch_up(ctx, cycles);                                                  \
+            DISPATCH();                                                             \
+        } while (0)
+
+    // increment pc if there was no branch
+    #define NEXT()                                                                  \
+        do                                                                          \
+        {                                                                           \
+            if (pipeline_full)                                                      \
+                IncrementPC();                                                      \
+            RETIRE();                                                               \
+        } while (0)
+
+    DISPATCH();
+
+    arm_skip:
+        IncrementPC();
+        Tick(0, 0, 1); // 1I
+        RETIRE();
+
+    arm_bex:  BranchExchange(instruction);       NEXT();
+    arm_b:    BranchLink(instruction);           NEXT();
+    arm_dp:   DataProcessing(instruction);       NEXT();
+    arm_mul:  Multiply(instruction);             NEXT();
+    arm_mull: MultiplyLong(instruction);         NEXT();
+    arm_psr:  PSRTransfer(instruction);          NEXT();
+    arm_sdt:  SingleDataTransfer(instruction);   NEXT();
+    arm_hdt:  HalfwordDataTransfer(instruction); NEXT();
+    arm_bdt:  BlockDataTransfer(instruction);    NEXT();
+    arm_swp:  SingleDataSwap(instruction);       NEXT();
+    arm_int:  SoftwareInterruptArm(instruction); NEXT();
+    arm_undef:
+        LOG(LogLevel::Error, "Cannot execute instruction {}, pc {}\n", instruction, registers.r15);
+        registers.r15 &= ~0x3;
+        NEXT();
+
+    thumb_msr:    MoveShiftedRegister(instruction);     NEXT();
+    thumb_addsub: AddSubtract(instruction);             NEXT();
+    thumb_imm:    MoveImmediate(instruction);           NEXT();
+    thumb_alu:    AluThumb(instruction);                NEXT();
+    thumb_hi:     HiRegisterOps(instruction);           NEXT();
+    thumb_pc:     PcRelLoad(instruction);               NEXT();
+    thumb_mov:    LoadStoreRegOffset(instruction);      NEXT();
+    thumb_movs:   LoadStoreSignedHalfword(instruction); NEXT();
+    thumb_movi:   LoadStoreImmediate(instruction);      NEXT();
+    thumb_movh:   LoadStoreHalfword(instruction);       NEXT();
+    thumb_sp:     SpRelLoadStore(instruction);          NEXT();
+    thumb_lda:    LoadAddress(instruction);             NEXT();
+    thumb_addsp:  AddOffsetToSp(instruction);           NEXT();
+    thumb_pop:    PushPop(instruction);                 NEXT();
+    thumb_movm:   MultipleLoadStore(instruction);       NEXT();
+    thumb_b:      ConditionalBranch(instruction);       NEXT();
+    thumb_swi:    SoftwareInterruptThumb(instruction);  NEXT();
+    thumb_bal:    UnconditionalBranch(instruction);     NEXT();
+    thumb_bl:     LongBranchLink(instruction);          NEXT();
+    thumb_und:
+        std::cerr << "Cannot execute thumb instruction: " << (u16) instruction << " " << std::hex << registers.r15 << "\n";
+        registers.r15 &= ~0x1;
+        NEXT();
+
+    #undef NEXT
+    #undef RETIRE
+    #undef DISPATCH
+}
+#endif
+
+// run the handler for a decoded arm instruction
+template <typename Accuracy>
+inline void Arm7Tdmi<Accuracy>::ExecuteArm(u32 instruction, ArmInstruction format)
+{
+    switch (format)
+    {
+        case ArmInstruction::BEX:  BranchExchange(instruction);       break;
+        case ArmInstruction::B:    BranchLink(instruction);           break;
+        case ArmInstruction::DP:   DataProcessing(instruction);       break;
+        case ArmInstruction::MUL:  Multiply(instruction);             break;
+        case ArmInstruction::MULL: MultiplyLong(instruction);         break;
+        case ArmInstruction::PSR:  PSRTransfer(instruction);          break;
+        case ArmInstruction::SDT:  SingleDataTransfer(instruction);   break;
+        case ArmInstruction::HDT:  HalfwordDataTransfer(instruction); break;
+        case ArmInstruction::BDT:  BlockDataTransfer(instruction);    break;
+        case ArmInstruction::SWP:  SingleDataSwap(instruction);       break;
+        case ArmInstruction::INT:  SoftwareInterruptArm(instruction); break;
+        default:
+            LOG(LogLevel::Error, "Cannot execute instruction {}, pc {}\n", instruction, registers.r15);
+            registers.r15 &= ~0x3;
+    }
+}
+
+// run the handler for a decoded thumb instruction
+template <typename Accuracy>
+inline void Arm7Tdmi<Accuracy>::ExecuteThumb(u16 instruction, ThumbInstruction format)
+{
+    switch (format)
+    {
+        case ThumbInstruction::MSR:    MoveShiftedRegister(instruction);     break;
+        case ThumbInstruction::ADDSUB: AddSubtract(instruction);             break;
+        case ThumbInstruction::IMM:    MoveImmediate(instruction);           break;
+        case ThumbInstruction::ALU:    AluThumb(instruction);                break;
+        case ThumbInstruction::HI:     HiRegisterOps(instruction);           break;
+        case ThumbInstruction::PC:     PcRelLoad(instruction);               break;
+        case ThumbInstruction::MOV:    LoadStoreRegOffset(instruction);      break;
+        case ThumbInstruction::MOVS:   LoadStoreSignedHalfword(instruction); break;
+        case ThumbInstruction::MOVI:   LoadStoreImmediate(instruction);      break;
+        case ThumbInstruction::MOVH:   LoadStoreHalfword(instruction);       break;
+        case ThumbInstruction::SP:     SpRelLoadStore(instruction);          break;
+        case ThumbInstruction::LDA:    LoadAddress(instruction);             break;
+        case ThumbInstruction::ADDSP:  AddOffsetToSp(instruction);           break;
+        case ThumbInstruction::POP:    PushPop(instruction);                 break;
+        case ThumbInstruction::MOVM:   MultipleLoadStore(instruction);       break;
+        case ThumbInstruction::B:      ConditionalBranch(instruction);       break;
+        case ThumbInstruction::SWI:    SoftwareInterruptThumb(instruction);  break;
+        case ThumbInstruction::BAL:    UnconditionalBranch(instruction);     break;
+        case ThumbInstruction::BL:     LongBranchLink(instruction);          break;
+        default:
+            std::cerr << "Cannot execute thumb instruction: " << instruction << " " << std::hex << registers.r15 << "\n";
+            registers.r15 &= ~0x1;
+    }
+}
+
+template <typename Accuracy>
+u32 Arm7Tdmi<Accuracy>::GetRegister(u32 reg)
 {
     switch (reg)
     {
@@ -389,7 +542,8 @@ u32 Arm7Tdmi::GetRegister(u32 reg)
     return 100; // should never happen
 }
 
-void Arm7Tdmi::SetRegister(u32 reg, u32 val)
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::SetRegister(u32 reg, u32 val)
 {
     switch (reg)
     {
@@ -520,7 +674,8 @@ void Arm7Tdmi::SetRegister(u32 reg, u32 val)
 }
 
 // update cpsr flags after a logical operation
-void Arm7Tdmi::UpdateFlagsLogical(u32 result, u8 carry_out)
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::UpdateFlagsLogical(u32 result, u8 carry_out)
 {
     // C flag will be set to the carry out from the barrel shifter
     SetConditionCodeFlag(ConditionFlag::C, carry_out);
@@ -535,7 +690,8 @@ void Arm7Tdmi::UpdateFlagsLogical(u32 result, u8 carry_out)
 }
 
 // update cpsr flags after an addition operation
-void Arm7Tdmi::UpdateFlagsAddition(u32 op1, u32 op2, u32 result)
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::UpdateFlagsAddition(u32 op1, u32 op2, u32 result)
 {
     // C flag will be set to the carry out of bit 31 of the ALU
     if (op1 > result || op2 > result)
@@ -565,7 +721,8 @@ void Arm7Tdmi::UpdateFlagsAddition(u32 op1, u32 op2, u32 result)
 }
 
 // update cpsr flags after a subtraction operation
-void Arm7Tdmi::UpdateFlagsSubtraction(u32 op1, u32 op2, u32 result)
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::UpdateFlagsSubtraction(u32 op1, u32 op2, u32 result)
 {
     // C flag will be set to the carry out of bit 31 of the ALU
     // ARM uses an inverted carry flag for borrow
@@ -604,7 +761,8 @@ void Arm7Tdmi::UpdateFlagsSubtraction(u32 op1, u32 op2, u32 result)
  *  num - the number that will actually be shifted
  *  opcode - an encoding of which type of shift to be performed
  */
-u8 Arm7Tdmi::BarrelShift(u32 shift_amount, u32 &num, u8 opcode)
+template <typename Accuracy>
+u8 Arm7Tdmi<Accuracy>::BarrelShift(u32 shift_amount, u32 &num, u8 opcode)
 {
     u8 carry_out = GetConditionCodeFlag(ConditionFlag::C); // preserve C flag
 
@@ -686,7 +844,8 @@ u8 Arm7Tdmi::BarrelShift(u32 shift_amount, u32 &num, u8 opcode)
     return carry_out;
 }
 
-inline void Arm7Tdmi::IncrementPC()
+template <typename Accuracy>
+inline void Arm7Tdmi<Accuracy>::IncrementPC()
 {
     registers.r15 += GetState() == State::ARM ? 4 : 2;
 }
@@ -695,7 +854,8 @@ inline void Arm7Tdmi::IncrementPC()
  * Updates the value in the cpsr
  * Can also change the emulator's state or mode depending on the value
  */ 
-void Arm7Tdmi::UpdateCPSR(u32 value, bool flags_only)
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::UpdateCPSR(u32 value, bool flags_only)
 {
     StatusRegister sr;
     sr.raw = value;
@@ -740,7 +900,8 @@ void Arm7Tdmi::UpdateCPSR(u32 value, bool flags_only)
 /*
  * Updates the value in the spsr <mode>
  */ 
-void Arm7Tdmi::UpdateSPSR(u32 value, bool flags_only)
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::UpdateSPSR(u32 value, bool flags_only)
 {
     StatusRegister old_spsr;
 
@@ -798,8 +959,17 @@ void Arm7Tdmi::UpdateSPSR(u32 value, bool flags_only)
 // advances the cpu clock
 // address is the current access address
 // type is the cycle type, either 'n', 's', or 'i'
-void Arm7Tdmi::Tick(u8 n, u8 s, u8 i)
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::Tick(u8 n, u8 s, u8 i)
 {
+    // fast core charges the power on waitstates whatever WAITCNT says, so it runs about as many
+    // instructions per frame as the cycle core rather than several times more
+    if constexpr (!Accuracy::waitstates)
+    {
+        ChargeCycles(n * (1 + DEFAULT_N_CYCLES) + s * (1 + DEFAULT_S_CYCLES) + i);
+        return;
+    }
+
     u16 access_cycles = 0;
 
     // non-sequential wait states
@@ -815,10 +985,27 @@ void Arm7Tdmi::Tick(u8 n, u8 s, u8 i)
         access_cycles += 1; // 1 cycle
     
     // keep running total of cycles
-    cycles += access_cycles;
+    ChargeCycles(access_cycles);
+}
+
+// add to the running total of cycles, divided by the overclock multiplier so that
+// the rest of the system (ppu, timers) sees time pass slower than the cpu does
+template <typename Accuracy>
+inline void Arm7Tdmi<Accuracy>::ChargeCycles(u32 n)
+{
+    if (clock_multiplier == 0x100)
+    {
+        cycles += n;
+        return;
+    }
+
+    u32 scaled = (n << 8) + cycle_fraction;
+    cycles += scaled / clock_multiplier;
+    cycle_fraction = scaled % clock_multiplier;
 }
 
-void Arm7Tdmi::HandleInterrupt()
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::HandleInterrupt()
 {
     // exit interrupt
     if (in_interrupt && GetRegister(r15) == 0x138)
@@ -952,7 +1139,8 @@ void Arm7Tdmi::HandleInterrupt()
     }
 }
 
-u8 Arm7Tdmi::Read8(u32 address)
+template <typename Accuracy>
+u8 Arm7Tdmi<Accuracy>::Read8(u32 address)
 {
     // reading from BIOS memory
     if (address <= 0x3FFF && registers.r15 > 0x3FFF)
@@ -1001,21 +1189,25 @@ u8 Arm7Tdmi::Read8(u32 address)
  * pass true if the halfword is signed, false otherwise
  * This needs to be known for misalignment reasons
  */
-u32 Arm7Tdmi::Read16(u32 address, bool sign)
+template <typename Accuracy>
+u32 Arm7Tdmi<Accuracy>::Read16(u32 address, bool sign)
 {
     // reading from BIOS memory
-    if (address <= 0x3FFF && registers.r15 > 0x3FFF)
+    if constexpr (Accuracy::bios_open_bus)
     {
-        LOG(LogLevel::Error, "Invalid read from BIOS u16: 0x{x}\n", last_read_bios);
-
-        u32 value = last_read_bios;
-        switch (address & 0x1)
+        if (address <= 0x3FFF && registers.r15 > 0x3FFF)
         {
-            case 0: value >>= 0;  break;
-            case 1: value >>= 16;  break;
-        }
+            LOG(LogLevel::Error, "Invalid read from BIOS u16: 0x{x}\n", last_read_bios);
+
+            u32 value = last_read_bios;
+            switch (address & 0x1)
+            {
+                case 0: value >>= 0;  break;
+                case 1: value >>= 16;  break;
+            }
 
-        return value & 0xFFFF;
+            return value & 0xFFFF;
+        }
     }
 
     bool valid = true;
@@ -1115,8 +1307,11 @@ u32 Arm7Tdmi::Read16(u32 address, bool sign)
         // read from forcibly aligned address
         data = (u32) mem->Read16(address & ~1);
         // misaligned read - reads from forcibly aligned address "addr AND 1", and does then rotate the data as "ROR 8"
-        if ((address & 1) != 0)
-            BarrelShift(8, data, 0b11);
+        if constexpr (Accuracy::misaligned_rotate)
+        {
+            if ((address & 1) != 0)
+                BarrelShift(8, data, 0b11);
+        }
     }
     
     return data;    
@@ -1127,11 +1322,15 @@ u32 Arm7Tdmi::Read16(u32 address, bool sign)
  * pass true if this is a LDR or SWP operation false otherwise
  * This needs to be known for misalignment reasons
  */
-u32 Arm7Tdmi::Read32(u32 address, bool ldr)
+template <typename Accuracy>
+u32 Arm7Tdmi<Accuracy>::Read32(u32 address, bool ldr)
 {
     // reading from BIOS memory
     if (address <= 0x3FFF)
     {
+        // fast core reads BIOS directly, without open bus tracking
+        if constexpr (!Accuracy::bios_open_bus)
+            return mem->Read32Unsafe(address & ~3);
 
         if (registers.r15 < 0x3FFF)
             last_read_bios = mem->Read32Unsafe(address);
@@ -1210,8 +1409,11 @@ u32 Arm7Tdmi::Read32(u32 address, bool ldr)
 
     // misaligned read - reads from forcibly aligned address "addr AND (NOT 3)", and does then rotate the data as "ROR (addr AND 3)*8"
     // only used for LDR and SWP operations, otherwise just use data from forcibly aligned address
-    if (ldr && ((address & 3) != 0))
-        BarrelShift((address & 3) << 3, data, 0b11);
+    if constexpr (Accuracy::misaligned_rotate)
+    {
+        if (ldr && ((address & 3) != 0))
+            BarrelShift((address & 3) << 3, data, 0b11);
+    }
 
     // 8 cycles for gamepak rom access, 5 from mem_check and 3 here
     // if (address >= MEM_GAMEPAK_ROM_START && address <= MEM_GAMEPAK_ROM_END)
@@ -1221,7 +1423,8 @@ u32 Arm7Tdmi::Read32(u32 address, bool ldr)
 }
 
 
-void Arm7Tdmi::Write8(u32 address, u8 value)
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::Write8(u32 address, u8 value)
 {
     if (!MemCheckWrite(address)) return;
 
@@ -1278,7 +1481,8 @@ void Arm7Tdmi::Write8(u32 address, u8 value)
     mem->Write8(address, value);
 }
 
-void Arm7Tdmi::Write16(u32 address, u16 value)
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::Write16(u32 address, u16 value)
 {
     // align address to halfword
     address &= ~0x1;
@@ -1287,7 +1491,8 @@ void Arm7Tdmi::Write16(u32 address, u16 value)
     mem->Write16(address, value);
 }
 
-void Arm7Tdmi::Write32(u32 address, u32 value)
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::Write32(u32 address, u32 value)
 {
     // align address to word
     address &= ~0x3;
@@ -1301,7 +1506,8 @@ void Arm7Tdmi::Write32(u32 address, u32 value)
 }
 
 // determine if a read at the specified address is allowed
-inline bool Arm7Tdmi::MemCheckRead(u32 &address)
+template <typename Accuracy>
+inline bool Arm7Tdmi<Accuracy>::MemCheckRead(u32 &address)
 {
     // upper 4 bits of address bus are unused
     // if (address >= 0x10000000)
@@ -1340,7 +1546,8 @@ inline bool Arm7Tdmi::MemCheckRead(u32 &address)
 }
 
 // determine if a write at the specified address is allowed
-inline bool Arm7Tdmi::MemCheckWrite(u32 &address)
+template <typename Accuracy>
+inline bool Arm7Tdmi<Accuracy>::MemCheckWrite(u32 &address)
 {
     // upper 4 bits of address bus are unused, so mirror it if trying to access
     if (address >= 0x10000000)
@@ -1349,8 +1556,11 @@ inline bool Arm7Tdmi::MemCheckWrite(u32 &address)
     // add cycles for expensive memory accesses
 
     // +1 cycles for VRAM accress while not in v-blank
-    if (address >= MEM_PALETTE_RAM_START && address <= MEM_OAM_END && !mem->stat->displaystat.in_vBlank)
-        cycles++;
+    if constexpr (Accuracy::waitstates)
+    {
+        if (address >= MEM_PALETTE_RAM_START && address <= MEM_OAM_END && !mem->stat->displaystat.in_vBlank)
+            ChargeCycles(1);
+    }
     
     // bios write
     if (address <= 0x3FFF)
@@ -1359,7 +1569,8 @@ inline bool Arm7Tdmi::MemCheckWrite(u32 &address)
     return true;
 }
 
-bool Arm7Tdmi::CheckState()
+template <typename Accuracy>
+bool Arm7Tdmi<Accuracy>::CheckState()
 {
     bool valid = false;
 
@@ -1380,4 +1591,8 @@ bool Arm7Tdmi::CheckState()
 
 #include "HandlerArm.cpp"
 #include "HandlerThumb.cpp"
-#include "swi.cpp"
\ No newline at end of file
+#include "swi.cpp"
+
+// both cores are compiled in, Discovery picks one at startup
+template class Arm7Tdmi<AccuracyCycle>;
+template class Arm7Tdmi<AccuracyFast>;
\ No newline at end of file
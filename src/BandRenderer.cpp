@@ -0,0 +1,49 @@
+/* discovery
+ * License: GPLv2
+ * See LICENSE.txt for full license text
+ *
+ * FILE: BandRenderer.cpp
+ * DATE: October 19th, 2026
+ * DESCRIPTION: draws a whole frame as bands of scanlines spread across cores
+ */
+
+#include <algorithm>
+
+#include "BandRenderer.h"
+
+BandRenderer::BandRenderer(TileCache *tiles, PaletteCache *palette, OamCache *objs, int threads)
+    : tiles(tiles), palette(palette), objs(objs), pool(threads)
+{
+    for (int i = 0; i < pool.Threads(); ++i)
+        renderers.emplace_back(new Renderer(tiles, palette, objs));
+}
+
+void BandRenderer::Reset()
+{
+    for (auto &renderer : renderers)
+        renderer->Reset();
+}
+
+void BandRenderer::DrawFrame(const ScanlineLog &log, void *screen, int pitch, u64 *hashes)
+{
+    DrawLines(log, 0, SCREEN_HEIGHT, screen, pitch, hashes);
+}
+
+void BandRenderer::DrawLines(const ScanlineLog &log, int first, int last, void *screen, int pitch, u64 *hashes)
+{
+    // nothing may be decoded lazily once the bands are running on several threads
+    if (pool.Threads() > 1)
+    {
+        tiles->Refresh();
+        palette->Refresh();
+        objs->Refresh();
+    }
+
+    pool.Run((last - first + BAND_LINES - 1) / BAND_LINES, [&](int band, int thread)
+    {
+        int end = std::min(first + (band + 1) * BAND_LINES, last);
+
+        for (int line = first + band * BAND_LINES; line < end; ++line)
+            hashes[line] = renderers[thread]->DrawLine(log, line, (u8 *) screen + line * pitch);
+    });
+}
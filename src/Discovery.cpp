@@ -9,7 +9,14 @@
  */
 #include <iostream>
 #include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <chrono>
 #include "Discovery.h"
+#include "Presenter.h"
 #include "Util.h"
 
 int main(int argc, char **argv)
@@ -45,6 +52,7 @@ int main(int argc, char **argv)
     // load bios, rom, and launch game loop
     emulator.mem->LoadBios(config::bios_name);
     emulator.mem->LoadRom(config::rom_name);
+    emulator.LoadGameConfig();
 
     emulator.GameLoop();
     return 0;
@@ -53,13 +61,20 @@ int main(int argc, char **argv)
 Discovery::Discovery()
 {
     system_cycles = 0;
+    old_cycles = 0;
     running = true;
 
+    keys         = 0x3FF; // all keys released
+    quit         = false;
+    toggle_turbo = false;
+    stopped      = false;
+
     stat    = new LcdStat();
     mem     = new Memory(stat);
 
-    cpu     = new Arm7Tdmi(mem);
-    ppu     = new PPU(mem, stat);
+    cpu      = NULL;
+    fast_cpu = NULL;
+    ppu      = new PPU(mem, stat);
     gamepad = new Gamepad();
 
     // initialize timers
@@ -82,24 +97,126 @@ Discovery::Discovery()
 
 void Discovery::GameLoop()
 {
-    u32 old_cycles = 0;
+    if (config::render_jobs < 1 || config::render_jobs > 64)
+    {
+        LOG(LogLevel::Error, "Error: render jobs must be between 1 and 64, got {}\n", config::render_jobs);
+        exit(1);
+    }
 
-    while (running)
+    PostConfig post;
+    post.lcd      = config::lcd;
+    post.ghosting = config::ghosting;
+    post.threads  = config::post_jobs;
+
+    if (!post.SetScaler(config::scaler))
     {
-        // tick hardware (not cpu) if in halt state
-        while (mem->haltcnt)
-        {
-            Tick();
+        LOG(LogLevel::Error, "Error: Unknown scaler {} (none, 2x - 8x, scale2x, scale3x or xbr)\n", config::scaler);
+        exit(1);
+    }
 
-            auto interrupts_enabled   = mem->Read16Unsafe(REG_IE);
-            auto interrupts_requested = mem->Read16Unsafe(REG_IF);
+    if (config::post_jobs < 1 || config::post_jobs > 64)
+    {
+        LOG(LogLevel::Error, "Error: post-processing jobs must be between 1 and 64, got {}\n", config::post_jobs);
+        exit(1);
+    }
 
-            if (interrupts_enabled & interrupts_requested != 0)
-            {
-                mem->haltcnt = 0;
-            }
-        }
+    PixelFormat format;
+
+    if (!ParsePixelFormat(config::pixel_format, format))
+    {
+        LOG(LogLevel::Error, "Error: Unknown pixel format {} (xrgb8888, rgb565, bgra8888 or bgr555)\n", config::pixel_format);
+        exit(1);
+    }
+
+    ppu->SetVideoSink(MakeVideoSink(config::video, post, format));
+
+    Presenter presenter(ppu);
+
+    if (!config::shm.empty())
+        presenter.StartShmExport(config::shm);
+
+    ParseFrameSkip();
+    ppu->limit = config::limit;
+
+    if (config::render_thread)
+        ppu->StartRenderThread(config::render_jobs);
+
+    // the cycle accurate core draws a line at a time as it goes, there's no frame to split
+    else if (config::render_jobs > 1 && !config::fast)
+        LOG(LogLevel::Warning, "--render-jobs needs --fast or --render-thread, ignoring it\n");
+
+    else if (config::render_jobs > 1)
+        ppu->StartBandRenderer(config::render_jobs);
+
+    // pick the core once, nothing inside Run branches on accuracy
+    if (config::fast)
+    {
+        LOG(LogLevel::Message, "Running fast core\n");
+        fast_cpu = new Arm7Tdmi<AccuracyFast>(mem);
+    }
+
+    else
+        cpu = new Arm7Tdmi<AccuracyCycle>(mem);
 
+    // emulate on a thread of its own, this one keeps the window: events in, frames out
+    std::thread emulation([this]
+    {
+        if (fast_cpu != NULL)
+            Run(fast_cpu);
+        else
+            Run(cpu);
+
+        stopped = true;
+    });
+
+    while (!stopped)
+    {
+        PollEvents();
+
+        // nothing new yet, a frame is ~16 ms so a short sleep costs no latency worth measuring
+        if (!presenter.Present())
+            std::this_thread::sleep_for(std::chrono::microseconds(500));
+    }
+
+    emulation.join();
+
+    // the last frame finished
+    presenter.Present();
+
+    ShutDown();
+}
+
+// hand window and keyboard events to the cpu's thread, see Tick
+void Discovery::PollEvents()
+{
+    SDL_Event e;
+
+    while (ppu->Sink().PollEvent(e))
+    {
+        if (e.type == SDL_QUIT)
+            quit = true;
+
+        // tab toggles turbo
+        if (e.type == SDL_KEYDOWN && e.key.keysym.sym == SDLK_TAB && !e.key.repeat)
+            toggle_turbo = true;
+
+        else if (e.type == SDL_KEYDOWN || e.type == SDL_KEYUP)
+            keys.store(gamepad->Poll(e), std::memory_order_relaxed);
+    }
+}
+
+template <typename Accuracy>
+void Discovery::Run(Arm7Tdmi<Accuracy> *cpu)
+{
+    old_cycles = 0;
+    cpu->clock_multiplier = (u32) (config::overclock * 0x100);
+
+    #ifdef THREADED_DISPATCH
+    // the cpu owns the loop and calls back into CatchUp after every instruction
+    cpu->Run(running, [](void *emulator, u32 cycles) { ((Discovery *) emulator)->CatchUp<Accuracy>(cycles); }, this);
+    #else
+    while (running)
+    {
         cpu->Fetch();
         cpu->Decode(cpu->pipeline[0]);
         cpu->Execute(cpu->pipeline[0]);
@@ -110,19 +227,40 @@ void Discovery::GameLoop()
         cpu->pipeline[0] = cpu->pipeline[1];
         cpu->pipeline[1] = cpu->pipeline[2];
 
-        // run hardware for as many clock cycles as cpu used
-        system_cycles = cpu->cycles;
-        while (old_cycles++ < system_cycles)
-            Tick();
+        CatchUp<Accuracy>(cpu->cycles);
     }
+    #endif
+}
 
-    ShutDown();
+// bring the rest of the system up to the cpu's cycle count
+template <typename Accuracy>
+void Discovery::CatchUp(u32 cpu_cycles)
+{
+    // run hardware for as many clock cycles as cpu used
+    system_cycles = cpu_cycles;
+    while (old_cycles++ < system_cycles)
+        Tick<Accuracy>();
+
+    // tick hardware (not cpu) if in halt state
+    while (mem->haltcnt)
+    {
+        Tick<Accuracy>();
+
+        auto interrupts_enabled   = mem->Read16Unsafe(REG_IE);
+        auto interrupts_requested = mem->Read16Unsafe(REG_IF);
+
+        if (interrupts_enabled & interrupts_requested != 0)
+        {
+            mem->haltcnt = 0;
+        }
+    }
 }
 
 // clock hardware components
+template <typename Accuracy>
 void Discovery::Tick()
 {
-    ppu->Tick();
+    ppu->Tick<Accuracy>();
 
     // clock timers
     for (int j = 0; j < 4; ++j)
@@ -169,16 +307,114 @@ void Discovery::Tick()
         }
     }
 
-    // poll for key presses at start of vblank
-    if (stat->scanline == VDRAW && SDL_PollEvent(&e))
+    // take input from the main thread at start of vblank, see PollEvents
+    if (stat->scanline == VDRAW)
     {
-        if (e.type == SDL_QUIT)
+        if (quit.load(std::memory_order_relaxed))
             running = false;
-        if (e.type == SDL_KEYDOWN || e.type == SDL_KEYUP)
-            mem->Write32Unsafe(REG_KEYINPUT, gamepad->Poll(e));
+
+        if (toggle_turbo.load(std::memory_order_relaxed) && toggle_turbo.exchange(false))
+        {
+            ppu->frameskip.turbo = !ppu->frameskip.turbo;
+            LOG(LogLevel::Message, "Turbo {}\n", ppu->frameskip.turbo ? "on" : "off");
+        }
+
+        u16 pressed = keys.load(std::memory_order_relaxed);
+
+        if (mem->Read16Unsafe(REG_KEYINPUT) != pressed)
+            mem->Write32Unsafe(REG_KEYINPUT, pressed);
     }
 }
 
+// a whole string as an overclock multiplier, false if any of it isn't a number or it isn't positive
+// (0 is config::overclock's "not given")
+static bool ParseOverclock(const char *text, double &multiplier)
+{
+    char *end;
+    multiplier = std::strtod(text, &end);
+
+    return end != text && *end == '\0' && multiplier > 0;
+}
+
+// apply the settings for this rom from config::game_config_name, command line flags take precedence
+void Discovery::LoadGameConfig()
+{
+    std::string game_code((char *) &mem->cart_rom[0xAC], 4); // from the cart header
+    std::ifstream file(config::game_config_name);
+    std::string line;
+
+    while (file && std::getline(file, line))
+    {
+        std::istringstream fields(line);
+        std::string code, setting;
+
+        if (!(fields >> code) || code[0] == '#' || code != game_code)
+            continue;
+
+        while (fields >> setting)
+        {
+            if (setting.rfind("overclock=", 0) == 0)
+            {
+                double multiplier;
+
+                if (!ParseOverclock(setting.c_str() + 10, multiplier))
+                    LOG(LogLevel::Warning, "Invalid {} for {} in {}, ignoring it\n", setting, game_code, config::game_config_name);
+
+                else if (config::overclock == 0)
+                    config::overclock = multiplier;
+            }
+
+            else
+                LOG(LogLevel::Warning, "Unknown setting {} for {} in {}\n", setting, game_code, config::game_config_name);
+        }
+    }
+
+    if (config::overclock == 0)
+        config::overclock = 1;
+
+    // 8.8 fixed point in Arm7Tdmi::ChargeCycles
+    if (config::overclock < 1 || config::overclock > 16)
+    {
+        LOG(LogLevel::Error, "Error: overclock must be between 1 and 16, got {}\n", config::overclock);
+        exit(1);
+    }
+
+    if (config::overclock != 1)
+        LOG(LogLevel::Message, "CPU overclocked {}x\n", config::overclock);
+}
+
+// config::frameskip is auto, N (skip N of every N + 1 frames) or N/M (skip N of every M)
+void Discovery::ParseFrameSkip()
+{
+    FrameSkip &skip = ppu->frameskip;
+    skip.turbo = config::turbo;
+
+    if (config::frameskip.empty())
+        return;
+
+    if (config::frameskip == "auto")
+    {
+        skip.automatic = true;
+        return;
+    }
+
+    int n, m;
+    char end;
+    int fields = std::sscanf(config::frameskip.c_str(), "%d/%d%c", &n, &m, &end);
+
+    if (fields == 1)
+        m = n + 1;
+
+    if ((fields != 1 && fields != 2) || n < 0 || m < 1 || n >= m)
+    {
+        LOG(LogLevel::Error, "Error: frameskip must be auto, N or N/M with N < M, got {}\n", config::frameskip);
+        exit(1);
+    }
+
+    skip.skip = n;
+    skip.of   = m;
+}
+
 // parse command line args
 void Discovery::ParseArgs()
 {
@@ -193,6 +429,42 @@ void Discovery::ParseArgs()
             config::bios_name = argv[++i];
 		else if ((argv[i] == "-h" || argv[i] == "--help") && i == 0)
 			config::show_help = true;
+        else if (argv[i] == "-f" || argv[i] == "--fast")
+            config::fast = true;
+        else if ((argv[i] == "-o" || argv[i] == "--overclock") && i != argv.size() - 1)
+        {
+            if (!ParseOverclock(argv[++i].c_str(), config::overclock))
+            {
+                LOG(LogLevel::Error, "Error: overclock must be a positive number, got {}\n", argv[i]);
+                exit(1);
+            }
+        }
+        else if (argv[i] == "--game-config" && i != argv.size() - 1)
+            config::game_config_name = argv[++i];
+        else if (argv[i] == "-r" || argv[i] == "--render-thread")
+            config::render_thread = true;
+        else if ((argv[i] == "-j" || argv[i] == "--render-jobs") && i != argv.size() - 1)
+            config::render_jobs = std::atoi(argv[++i].c_str());
+        else if (argv[i] == "--frameskip" && i != argv.size() - 1)
+            config::frameskip = argv[++i];
+        else if (argv[i] == "-t" || argv[i] == "--turbo")
+            config::turbo = true;
+        else if (argv[i] == "--no-limit")
+            config::limit = false;
+        else if (argv[i] == "--scaler" && i != argv.size() - 1)
+            config::scaler = argv[++i];
+        else if (argv[i] == "--lcd")
+            config::lcd = true;
+        else if (argv[i] == "--ghosting")
+            config::ghosting = true;
+        else if (argv[i] == "--post-jobs" && i != argv.size() - 1)
+            config::post_jobs = std::atoi(argv[++i].c_str());
+        else if (argv[i] == "--video" && i != argv.size() - 1)
+            config::video = argv[++i];
+        else if (argv[i] == "--pixel-format" && i != argv.size() - 1)
+            config::pixel_format = argv[++i];
+        else if (argv[i] == "--shm" && i != argv.size() - 1)
+            config::shm = argv[++i];
     }
 }
 
@@ -206,14 +478,55 @@ void Discovery::PrintArgHelp()
 	LOG("  Specifies input file for rom\n");
 	LOG("-b, --bios\n");
 	LOG("  Specifies GBA bios file\n");
+	LOG("-f, --fast\n");
+	LOG("  Run the fast core (fixed waitstates, no BIOS open bus or per-scanline rendering)\n");
+	LOG("-o, --overclock\n");
+	LOG("  Multiply the CPU clock (1 - 16) without changing video timing, e.g. -o 2\n");
+	LOG("--game-config\n");
+	LOG("  Per game settings file (default games.cfg)\n");
+	LOG("-r, --render-thread\n");
+	LOG("  Draw frames on another core, one frame behind the CPU\n");
+	LOG("-j, --render-jobs\n");
+	LOG("  Split each frame across this many cores (with --fast or --render-thread), e.g. -j 4\n");
+	LOG("--frameskip\n");
+	LOG("  Skip drawing frames: N (N of every N + 1), N/M (N of every M) or auto (when behind real time)\n");
+	LOG("-t, --turbo\n");
+	LOG("  Run uncapped, drawing only as many frames as a monitor shows (toggle with Tab)\n");
+	LOG("--no-limit\n");
+	LOG("  Run as fast as possible, drawing every frame (default is the GBA's 59.73 fps)\n");
+	LOG("--video\n");
+	LOG("  Where frames go: sdl (default), null, memory or file:<path> (raw frames)\n");
+	LOG("--pixel-format\n");
+	LOG("  Format frames are drawn in: xrgb8888 (default), rgb565, bgra8888 or bgr555\n");
+	LOG("--shm\n");
+	LOG("  Also publish every frame to a POSIX shared memory ring for other programs, e.g. --shm discovery\n");
+	LOG("--scaler\n");
+	LOG("  Upscale the window's picture: none (default), 2x - 8x (nearest neighbor), scale2x, scale3x or xbr\n");
+	LOG("--lcd\n");
+	LOG("  Correct colors for the GBA's LCD\n");
+	LOG("--ghosting\n");
+	LOG("  Blend each frame with the last one, like the GBA's slow LCD\n");
+	LOG("--post-jobs\n");
+	LOG("  Cores to run --scaler, --lcd and --ghosting on, e.g. --post-jobs 2\n");
 	LOG("-h, --help\n");
 	LOG("  Show help...\n");
 }
 
 void Discovery::ShutDown()
 {
+    LOG(LogLevel::Message, "Lag frames: {}\n", ppu->lag_frames);
+
+    if (ppu->frameskip.skipped)
+        LOG(LogLevel::Message, "Skipped frames: {}\n", ppu->frameskip.skipped);
+
+    auto times = ppu->pacer.GetStats();
+    if (times.frames)
+        LOG(LogLevel::Message, "Frame time: {:.3f} ms mean, {:.3f} ms stddev, {:.3f} - {:.3f} ms, {} late\n",
+            times.mean_ms, times.stddev_ms, times.min_ms, times.max_ms, times.late);
+
     // free resources and shutdown
 	delete cpu;
+    delete fast_cpu;
     delete ppu;
     delete mem;
     delete stat;
@@ -0,0 +1,104 @@
+/* discovery
+ * License: GPLv2
+ * See LICENSE.txt for full license text
+ *
+ * FILE: FramePacer.cpp
+ * DATE: October 19th, 2026
+ * DESCRIPTION: holds emulation to the gba's refresh rate on the monotonic clock, and times frames
+ */
+
+#include <time.h>
+#include <cerrno>
+#include <cmath>
+#include <algorithm>
+
+#include "FramePacer.h"
+
+FramePacer::FramePacer(double hz)
+{
+    period   = (u64) (1e9 / hz);
+    deadline = 0;
+    spin     = 300000;
+
+    last_end = 0;
+    frames   = 0;
+    late     = 0;
+    mean     = 0;
+    m2       = 0;
+    min      = 0;
+    max      = 0;
+}
+
+u64 FramePacer::Now()
+{
+    timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (u64) now.tv_sec * 1000000000 + now.tv_nsec;
+}
+
+void FramePacer::EndFrame(bool wait)
+{
+    u64 now = Now();
+
+    // uncapped, the first frame, or too far behind to catch up
+    if (!wait || deadline == 0 || now > deadline + period * MAX_BEHIND)
+        deadline = now + period;
+
+    else
+    {
+        if (now > deadline)
+            ++late;
+        else
+            WaitUntil(deadline);
+
+        deadline += period;
+        now = Now();
+    }
+
+    Record(now);
+}
+
+// sleep through most of the wait and spin through the rest, the kernel often wakes us late
+void FramePacer::WaitUntil(u64 time)
+{
+    u64 now = Now();
+
+    if (time > now + spin)
+    {
+        u64 wake = time - spin;
+        timespec until = { (time_t) (wake / 1000000000), (long) (wake % 1000000000) };
+
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &until, NULL) == EINTR)
+            ;
+
+        // oversleeping by more than the margin would make us late, grow the margin fast and shrink it slowly
+        u64 oversleep = Now() - wake;
+        spin = std::clamp(std::max(spin - spin / 16, oversleep * 2), MIN_SPIN, MAX_SPIN);
+    }
+
+    while (Now() < time)
+        ;
+}
+
+void FramePacer::Record(u64 now)
+{
+    if (last_end != 0)
+    {
+        double ms = (now - last_end) / 1e6;
+
+        min = frames == 0 ? ms : std::min(min, ms);
+        max = frames == 0 ? ms : std::max(max, ms);
+
+        ++frames;
+        double delta = ms - mean;
+        mean += delta / frames;
+        m2   += delta * (ms - mean);
+    }
+
+    last_end = now;
+}
+
+FramePacer::Stats FramePacer::GetStats() const
+{
+    return { frames, late, mean, frames > 1 ? std::sqrt(m2 / (frames - 1)) : 0, min, max };
+}
@@ -14,7 +14,8 @@
  * flushes the pipeline, and restarts execution from the address
  * contained in Rn. If bit 0 of Rn is 1, switch to THUMB mode
  */
-void Arm7Tdmi::BranchExchange(u32 instruction)
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::BranchExchange(u32 instruction)
 {
     u32 Rn = Util::bitseq<3, 0>(instruction);
 
@@ -44,7 +45,8 @@ void Arm7Tdmi::BranchExchange(u32 instruction)
     Tick(1, 2, 0);
 }
 
-void Arm7Tdmi::BranchLink(u32 instruction)
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::BranchLink(u32 instruction)
 {
     bool link  = Util::bitseq<24, 24>(instruction);
     u32 offset = Util::bitseq<23, 0>(instruction);
@@ -77,7 +79,8 @@ void Arm7Tdmi::BranchLink(u32 instruction)
     Tick(1, 2, 0);
 }
 
- void Arm7Tdmi::DataProcessing(u32 instruction)
+ template <typename Accuracy>
+ void Arm7Tdmi<Accuracy>::DataProcessing(u32 instruction)
  {
     u32 Rd = Util::bitseq<15, 12>(instruction); // destination register
     u32 Rn = Util::bitseq<19, 16>(instruction); // source register
@@ -263,7 +266,8 @@ void Arm7Tdmi::BranchLink(u32 instruction)
     Tick(n, s, i); 
 }
 
-void Arm7Tdmi::Multiply(u32 instruction)
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::Multiply(u32 instruction)
 {
     // assign registers
     u32 Rm = Util::bitseq<3, 0>(instruction);   // first operand
@@ -324,7 +328,8 @@ void Arm7Tdmi::Multiply(u32 instruction)
     Tick(0, 1, m);
 }
 
-void Arm7Tdmi::MultiplyLong(u32 instruction)
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::MultiplyLong(u32 instruction)
 {
     u32 RdHi                = Util::bitseq<19, 16>(instruction);
     u32 RdLo                = Util::bitseq<15, 12>(instruction);
@@ -466,7 +471,8 @@ void Arm7Tdmi::MultiplyLong(u32 instruction)
 }
 
 // allow access to CPSR and SPSR registers
- void Arm7Tdmi::PSRTransfer(u32 instruction)
+ template <typename Accuracy>
+ void Arm7Tdmi<Accuracy>::PSRTransfer(u32 instruction)
  {
     bool use_spsr = Util::bitseq<22, 22>(instruction) == 1;
     u32 opcode    = Util::bitseq<21, 21>(instruction);
@@ -529,7 +535,8 @@ void Arm7Tdmi::MultiplyLong(u32 instruction)
 }
 
 // store or load single value to/from memory
-void Arm7Tdmi::SingleDataTransfer(u32 instruction)
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::SingleDataTransfer(u32 instruction)
 {
     bool immediate  = Util::bitseq<25, 25>(instruction) == 0;
     bool pre_index  = Util::bitseq<24, 24>(instruction) == 1;  // bit 24 set = pre index, bit 24 0 = post index
@@ -649,7 +656,8 @@ void Arm7Tdmi::SingleDataTransfer(u32 instruction)
 }
 
 // transfer halfword and signed data
-void Arm7Tdmi::HalfwordDataTransfer(u32 instruction)
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::HalfwordDataTransfer(u32 instruction)
 {
     bool pre_index  = Util::bitseq<24, 24>(instruction) == 1; // bit 24 set = pre index, bit 24 0 = post index
     bool up         = Util::bitseq<23, 23>(instruction) == 1; // bit 23 set = up, bit 23 0 = down
@@ -772,7 +780,8 @@ void Arm7Tdmi::HalfwordDataTransfer(u32 instruction)
     Tick(n, s, i);
 }
 
-void Arm7Tdmi::BlockDataTransfer(u32 instruction)
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::BlockDataTransfer(u32 instruction)
 {
     bool pre_index    = Util::bitseq<24, 24>(instruction) == 1; // bit 24 set = pre index, bit 24 0 = post index
     bool up           = Util::bitseq<23, 23>(instruction) == 1; // bit 23 set = up, bit 23 0 = down
@@ -975,7 +984,8 @@ void Arm7Tdmi::BlockDataTransfer(u32 instruction)
     Tick(n, s, i);
 }
 
-void Arm7Tdmi::SingleDataSwap(u32 instruction)
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::SingleDataSwap(u32 instruction)
 {
     bool byte = Util::bitseq<22, 22>(instruction);
     u32 Rn    = Util::bitseq<19, 16>(instruction); // base register
@@ -1012,7 +1022,8 @@ void Arm7Tdmi::SingleDataSwap(u32 instruction)
     Tick(2, 1, 1);
 }
 
-void Arm7Tdmi::SoftwareInterruptArm(u32 instruction)
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::SoftwareInterruptArm(u32 instruction)
 {
     LOG(LogLevel::Debug, "ARM SWI: {}\n", instruction >> 16 & 0xFF);
 
@@ -8,7 +8,8 @@
  */
 #include "Arm7Tdmi.h"
 
-void Arm7Tdmi::MoveShiftedRegister(u16 instruction)
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::MoveShiftedRegister(u16 instruction)
 {
     u16 Rs         = Util::bitseq<5, 3>(instruction);
     u16 Rd         = Util::bitseq<2, 0>(instruction); 
@@ -33,7 +34,8 @@ void Arm7Tdmi::MoveShiftedRegister(u16 instruction)
     Tick(0, 1, 0);
 }
 
-void Arm7Tdmi::AddSubtract(u16 instruction)
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::AddSubtract(u16 instruction)
 {
     u16 Rs         = Util::bitseq<5, 3>(instruction);
     u16 Rd         = Util::bitseq<2, 0>(instruction);
@@ -67,7 +69,8 @@ void Arm7Tdmi::AddSubtract(u16 instruction)
     Tick(0, 1, 0);
 }
 
-void Arm7Tdmi::MoveImmediate(u16 instruction)
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::MoveImmediate(u16 instruction)
 {
     u16 offset8 = Util::bitseq<7, 0>(instruction);
     u16 Rd      = Util::bitseq<10, 8>(instruction);
@@ -103,7 +106,8 @@ void Arm7Tdmi::MoveImmediate(u16 instruction)
     Tick(0, 1, 0);
 }
 
-void Arm7Tdmi::AluThumb(u16 instruction)
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::AluThumb(u16 instruction)
 {
     u16 Rs     = Util::bitseq<5, 3>(instruction);
     u16 Rd     = Util::bitseq<2, 0>(instruction); 
@@ -241,7 +245,8 @@ void Arm7Tdmi::AluThumb(u16 instruction)
     Tick(n, s, i);
 }
 
-void Arm7Tdmi::HiRegisterOps(u16 instruction)
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::HiRegisterOps(u16 instruction)
 {
     u16 Rs     = Util::bitseq<5, 3>(instruction);
     u16 Rd     = Util::bitseq<2, 0>(instruction); 
@@ -362,7 +367,8 @@ void Arm7Tdmi::HiRegisterOps(u16 instruction)
     Tick(n, s, i);
 }
 
-void Arm7Tdmi::PcRelLoad(u16 instruction)
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::PcRelLoad(u16 instruction)
 {
     u16 Rd = Util::bitseq<10, 8>(instruction); 
     u16 word8 = Util::bitseq<7, 0>(instruction);
@@ -378,7 +384,8 @@ void Arm7Tdmi::PcRelLoad(u16 instruction)
     Tick(1, 1, 1);
 }
 
-void Arm7Tdmi::LoadStoreRegOffset(u16 instruction)
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::LoadStoreRegOffset(u16 instruction)
 {
     u16 Ro = Util::bitseq<8, 6>(instruction); // offset register
     u16 Rb = Util::bitseq<5, 3>(instruction); // base register
@@ -424,7 +431,8 @@ void Arm7Tdmi::LoadStoreRegOffset(u16 instruction)
     Tick(n, s, i);
 }
 
-void Arm7Tdmi::LoadStoreSignedHalfword(u16 instruction)
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::LoadStoreSignedHalfword(u16 instruction)
 {
     u16 Ro = Util::bitseq<8, 6>(instruction); // offset register
     u16 Rb = Util::bitseq<5, 3>(instruction); // base register
@@ -486,7 +494,8 @@ void Arm7Tdmi::LoadStoreSignedHalfword(u16 instruction)
     Tick(n, s, i);
 }
 
-void Arm7Tdmi::LoadStoreImmediate(u16 instruction)
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::LoadStoreImmediate(u16 instruction)
 {
     u16 Rb      = Util::bitseq<5, 3>(instruction);  // base register
     u16 Rd      = Util::bitseq<2, 0>(instruction);  // destination register
@@ -543,7 +552,8 @@ void Arm7Tdmi::LoadStoreImmediate(u16 instruction)
     Tick(n, s, i);
 }
 
-void Arm7Tdmi::LoadStoreHalfword(u16 instruction)
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::LoadStoreHalfword(u16 instruction)
 {
     u16 Rb      = Util::bitseq<5, 3>(instruction);  // base register
     u16 Rd      = Util::bitseq<2, 0>(instruction);  // destination register
@@ -581,7 +591,8 @@ void Arm7Tdmi::LoadStoreHalfword(u16 instruction)
     Tick(n, s, i);
 }
 
-void Arm7Tdmi::SpRelLoadStore(u16 instruction)
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::SpRelLoadStore(u16 instruction)
 {
     u16 Rd    = Util::bitseq<10, 8>(instruction); // destination register
     u16 word8 = Util::bitseq<7, 0>(instruction);  // 8 bit immediate offset
@@ -618,7 +629,8 @@ void Arm7Tdmi::SpRelLoadStore(u16 instruction)
     Tick(n, s, i);
 }
 
-void Arm7Tdmi::LoadAddress(u16 instruction)
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::LoadAddress(u16 instruction)
 {
     u16 Rd    = Util::bitseq<10, 8>(instruction);       // destination register
     u16 word8 = Util::bitseq<7, 0>(instruction);        // 8 bit immediate offset
@@ -647,7 +659,8 @@ void Arm7Tdmi::LoadAddress(u16 instruction)
     Tick(0, 1, 0);
 }
 
-void Arm7Tdmi::AddOffsetToSp(u16 instruction)
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::AddOffsetToSp(u16 instruction)
 {
     u16 sword8 = Util::bitseq<6, 0>(instruction); // 7 bit signed immediate value
     bool positive = Util::bitseq<7, 7>(instruction) == 0; // sign bit of sword8
@@ -667,7 +680,8 @@ void Arm7Tdmi::AddOffsetToSp(u16 instruction)
     Tick(0, 1, 0);
 }
 
-void Arm7Tdmi::PushPop(u16 instruction)
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::PushPop(u16 instruction)
 {
     bool load = Util::bitseq<11, 11>(instruction) == 1;
     bool R    = Util::bitseq<8, 8>(instruction) == 1; // PC/LR bit
@@ -770,7 +784,8 @@ void Arm7Tdmi::PushPop(u16 instruction)
     Tick(n, s, i);
 }
 
-void Arm7Tdmi::MultipleLoadStore(u16 instruction)
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::MultipleLoadStore(u16 instruction)
 {
     u16 Rb    = Util::bitseq<10, 8>(instruction); // base register
     bool load = Util::bitseq<11, 11>(instruction) == 1;
@@ -848,7 +863,8 @@ void Arm7Tdmi::MultipleLoadStore(u16 instruction)
     Tick(n, s, i);
 }
 
-void Arm7Tdmi::ConditionalBranch(u16 instruction)
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::ConditionalBranch(u16 instruction)
 {
     u16 soffset8 = Util::bitseq<7, 0>(instruction); // signed 8 bit offset
     Condition condition = (Condition) Util::bitseq<11, 8>(instruction);
@@ -886,7 +902,8 @@ void Arm7Tdmi::ConditionalBranch(u16 instruction)
     Tick(1, 2, 0);
 }
 
-void Arm7Tdmi::SoftwareInterruptThumb(u16 instruction)
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::SoftwareInterruptThumb(u16 instruction)
 {
     LOG(LogLevel::Debug, "Thumb SWI: {}\n", instruction & 0xFF);
 
@@ -924,7 +941,8 @@ void Arm7Tdmi::SoftwareInterruptThumb(u16 instruction)
     Tick(1, 2, 0);
 }
 
-void Arm7Tdmi::UnconditionalBranch(u16 instruction)
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::UnconditionalBranch(u16 instruction)
 {
     u16 offset11 = Util::bitseq<10, 0>(instruction); // signed 11 bit offset
     u32 base = GetRegister(r15);
@@ -960,7 +978,8 @@ void Arm7Tdmi::UnconditionalBranch(u16 instruction)
     Tick(1, 2, 0);
 }
 
-void Arm7Tdmi::LongBranchLink(u16 instruction)
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::LongBranchLink(u16 instruction)
 {
     u32 offset = Util::bitseq<10, 0>(instruction);       // long branch offset
     bool H     = Util::bitseq<11, 11>(instruction) == 1; // high/low offset bit
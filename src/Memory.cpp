@@ -20,11 +20,16 @@ Memory::Memory(LcdStat *stat) : stat(stat)
 {
     // cart_rom  = NULL;
     cart_ram  = NULL;
+    video_writes = NULL;
 
     timers[0] = NULL;
     timers[1] = NULL;
     timers[2] = NULL;
     timers[3] = NULL;
+
+    tiles.vram   = &memory[MEM_VRAM_START];
+    palette.pram = &memory[MEM_PALETTE_RAM_START];
+    objs.oam     = &memory[MEM_OAM_START];
     Reset();
 }
 
@@ -33,8 +38,8 @@ Memory::~Memory() { }
 void Memory::Reset()
 {
     // default cycle accesses for wait statae
-    n_cycles = 4;
-    s_cycles = 2;
+    n_cycles = DEFAULT_N_CYCLES;
+    s_cycles = DEFAULT_S_CYCLES;
 
     rom_size = 0;
     ram_size = 0;
@@ -43,6 +48,10 @@ void Memory::Reset()
     for (int i = 0; i < MEM_SIZE; ++i)
         memory[i] = 0;
 
+    tiles.InvalidateAll();
+    palette.InvalidateAll();
+    objs.InvalidateAll();
+
     for (int i = 0; i < 0x2000000; ++i)
         cart_rom[i] = 0;
 
@@ -63,6 +72,7 @@ void Memory::Reset()
     }
 
     haltcnt = 0;
+    keyinput_read = false;
 
     // write all 1s to keypad (all keys cleared)
     Write32Unsafe(REG_KEYINPUT, 0b1111111111);
@@ -302,6 +312,13 @@ u8 Memory::Read8(u32 address)
             return timers[3]->data & 0xFF;
         case REG_TM3D + 1:
             return (timers[3]->data >> 8) & 0xFF;
+
+        // a frame without a KEYINPUT read is a lag frame
+        case REG_KEYINPUT:
+        case REG_KEYINPUT + 1:
+            keyinput_read = true;
+            return memory[address];
+
         default:
             return memory[address];
     }
@@ -346,6 +363,10 @@ void Memory::Write8(u32 address, u8 value)
         // Palette RAM
         case 0x5:
             address &= MEM_PALETTE_RAM_END;
+            palette.Invalidate(address - MEM_PALETTE_RAM_START);
+
+            if (video_writes != NULL)
+                video_writes->Write(address, value, *stat);
             break;
 
         // VRAM
@@ -355,6 +376,10 @@ void Memory::Write8(u32 address, u8 value)
                 address -= 0x8000;
 
             address &= 0x601FFFF;
+            tiles.Invalidate(address - MEM_VRAM_START);
+
+            if (video_writes != NULL)
+                video_writes->Write(address, value, *stat);
             break;
 
         // OAM
@@ -364,6 +389,10 @@ void Memory::Write8(u32 address, u8 value)
             if (!stat->dispcnt.hb && stat->displaystat.in_hBlank)
                 return;
 
+            objs.Invalidate(address - MEM_OAM_START);
+
+            if (video_writes != NULL)
+                video_writes->Write(address, value, *stat);
             break;
 
         // ROM image 1
@@ -411,6 +440,10 @@ void Memory::Write8(u32 address, u8 value)
     // write value at memory location
     memory[address] = value;
 
+    // display registers the ppu snapshots per scanline, see ScanlineLog
+    if ((address >= REG_DISPCNT && address < REG_DISPSTAT) || (address >= REG_BG0CNT && address <= REG_BLDY + 1))
+        stat->regs_dirty = true;
+
     switch (address)
     {
         // REG_DISPCNT
@@ -548,6 +581,90 @@ void Memory::Write8(u32 address, u8 value)
             stat->bgcnt[3].voff = (memory[REG_BG3VOFS + 1] << 8) | (memory[REG_BG3VOFS]);
             break;
 
+        // REG_BG2PA
+        case REG_BG2PA:
+        case REG_BG2PA + 1:
+            stat->bgaffine[0].pa = memory[REG_BG2PA + 1] << 8 | memory[REG_BG2PA];
+            break;
+
+        // REG_BG2PB
+        case REG_BG2PB:
+        case REG_BG2PB + 1:
+            stat->bgaffine[0].pb = memory[REG_BG2PB + 1] << 8 | memory[REG_BG2PB];
+            break;
+
+        // REG_BG2PC
+        case REG_BG2PC:
+        case REG_BG2PC + 1:
+            stat->bgaffine[0].pc = memory[REG_BG2PC + 1] << 8 | memory[REG_BG2PC];
+            break;
+
+        // REG_BG2PD
+        case REG_BG2PD:
+        case REG_BG2PD + 1:
+            stat->bgaffine[0].pd = memory[REG_BG2PD + 1] << 8 | memory[REG_BG2PD];
+            break;
+
+        // REG_BG2X, 28 bit signed, also reloads the internal reference point
+        case REG_BG2X:
+        case REG_BG2X + 1:
+        case REG_BG2X + 2:
+        case REG_BG2X + 3:
+            stat->bgaffine[0].x = (s32) (Read32Unsafe(REG_BG2X) << 4) >> 4;
+            stat->bgaffine[0].ref_x = stat->bgaffine[0].x;
+            break;
+
+        // REG_BG2Y, 28 bit signed, also reloads the internal reference point
+        case REG_BG2Y:
+        case REG_BG2Y + 1:
+        case REG_BG2Y + 2:
+        case REG_BG2Y + 3:
+            stat->bgaffine[0].y = (s32) (Read32Unsafe(REG_BG2Y) << 4) >> 4;
+            stat->bgaffine[0].ref_y = stat->bgaffine[0].y;
+            break;
+
+        // REG_BG3PA
+        case REG_BG3PA:
+        case REG_BG3PA + 1:
+            stat->bgaffine[1].pa = memory[REG_BG3PA + 1] << 8 | memory[REG_BG3PA];
+            break;
+
+        // REG_BG3PB
+        case REG_BG3PB:
+        case REG_BG3PB + 1:
+            stat->bgaffine[1].pb = memory[REG_BG3PB + 1] << 8 | memory[REG_BG3PB];
+            break;
+
+        // REG_BG3PC
+        case REG_BG3PC:
+        case REG_BG3PC + 1:
+            stat->bgaffine[1].pc = memory[REG_BG3PC + 1] << 8 | memory[REG_BG3PC];
+            break;
+
+        // REG_BG3PD
+        case REG_BG3PD:
+        case REG_BG3PD + 1:
+            stat->bgaffine[1].pd = memory[REG_BG3PD + 1] << 8 | memory[REG_BG3PD];
+            break;
+
+        // REG_BG3X, 28 bit signed, also reloads the internal reference point
+        case REG_BG3X:
+        case REG_BG3X + 1:
+        case REG_BG3X + 2:
+        case REG_BG3X + 3:
+            stat->bgaffine[1].x = (s32) (Read32Unsafe(REG_BG3X) << 4) >> 4;
+            stat->bgaffine[1].ref_x = stat->bgaffine[1].x;
+            break;
+
+        // REG_BG3Y, 28 bit signed, also reloads the internal reference point
+        case REG_BG3Y:
+        case REG_BG3Y + 1:
+        case REG_BG3Y + 2:
+        case REG_BG3Y + 3:
+            stat->bgaffine[1].y = (s32) (Read32Unsafe(REG_BG3Y) << 4) >> 4;
+            stat->bgaffine[1].ref_y = stat->bgaffine[1].y;
+            break;
+
         // write into waitstate ctl
         case WAITCNT:
             switch(value >> 2 & 0b11) // bits 2-3
@@ -829,6 +946,18 @@ void Memory::Write16Unsafe(u32 address, u16 value)
 void Memory::Write8Unsafe(u32 address, u8 value)
 {
     memory[address] = value;
+
+    if (address >> 24 == 0x5)
+        palette.Invalidate(address - MEM_PALETTE_RAM_START);
+
+    if (address >> 24 == 0x6)
+        tiles.Invalidate(address - MEM_VRAM_START);
+
+    if (address >> 24 == 0x7)
+        objs.Invalidate(address - MEM_OAM_START);
+
+    if (video_writes != NULL && address >> 24 >= 0x5 && address >> 24 <= 0x7)
+        video_writes->Write(address, value, *stat);
 }
 
 void Memory::_Dma(int n)
@@ -0,0 +1,341 @@
+/* discovery
+ * License: GPLv2
+ * See LICENSE.txt for full license text
+ *
+ * FILE: PostProcess.cpp
+ * DATE: October 19th, 2026
+ * DESCRIPTION: filters finished frames for display - lcd color correction, ghosting and upscaling
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include "PostProcess.h"
+#include "Simd.h"
+
+bool PostConfig::SetScaler(const std::string &name)
+{
+    if (name == "none")    { scaler = Scaler::None;    return true; }
+    if (name == "scale2x") { scaler = Scaler::Scale2x; return true; }
+    if (name == "scale3x") { scaler = Scaler::Scale3x; return true; }
+    if (name == "xbr")     { scaler = Scaler::Xbr2x;   return true; }
+
+    // integer nearest neighbor, 2x - 8x
+    if (name.size() == 2 && name[1] == 'x' && name[0] >= '2' && name[0] <= '8')
+    {
+        scaler = Scaler::Nearest;
+        scale  = name[0] - '0';
+        return true;
+    }
+
+    return false;
+}
+
+PostProcess::PostProcess(const PostConfig &config) : config(config), pool(config.threads)
+{
+    switch (config.scaler)
+    {
+        case Scaler::None:    factor = 1;            break;
+        case Scaler::Nearest: factor = config.scale; break;
+        case Scaler::Scale2x: factor = 2;            break;
+        case Scaler::Scale3x: factor = 3;            break;
+        case Scaler::Xbr2x:   factor = 2;            break;
+    }
+
+    colors.resize(SCREEN_WIDTH * SCREEN_HEIGHT);
+
+    if (config.scaler == Scaler::Xbr2x)
+        yuv.resize(SCREEN_WIDTH * SCREEN_HEIGHT);
+
+    if (config.lcd)
+        BuildLcdLut();
+}
+
+void PostProcess::Run(const u32 *frame, u32 *out, int pitch)
+{
+    bool color = config.lcd || config.ghosting;
+    bool scale = config.scaler != Scaler::None;
+
+    const u32 *src = color ? colors.data() : frame;
+    int bands = SCREEN_HEIGHT / BAND_LINES;
+
+    // per pixel work, and the colors xbr compares
+    if (color || !yuv.empty())
+    {
+        pool.Run(bands, [&](int band, int)
+        {
+            for (int line = band * BAND_LINES; line < (band + 1) * BAND_LINES; ++line)
+            {
+                if (color)
+                    Color(frame, line, scale ? &colors[line * SCREEN_WIDTH] : out + line * pitch);
+
+                if (!yuv.empty())
+                    Simd::RgbToYuv(&src[line * SCREEN_WIDTH], &yuv[line * SCREEN_WIDTH], SCREEN_WIDTH);
+            }
+        });
+    }
+
+    // scalers read the lines above and below, so they wait for the whole color pass
+    if (scale)
+    {
+        pool.Run(bands, [&](int band, int)
+        {
+            for (int line = band * BAND_LINES; line < (band + 1) * BAND_LINES; ++line)
+                Scale(src, line, out, pitch);
+        });
+    }
+}
+
+// lcd colors, then ghosting against the last frame shown, which colors holds
+void PostProcess::Color(const u32 *frame, int line, u32 *out)
+{
+    const u32 *in = frame + line * SCREEN_WIDTH;
+    u32 corrected[SCREEN_WIDTH];
+
+    if (config.lcd)
+    {
+        Simd::ColorLut(in, lut.data(), corrected, SCREEN_WIDTH);
+        in = corrected;
+    }
+
+    if (config.ghosting)
+    {
+        u32 *last = &colors[line * SCREEN_WIDTH];
+        // rounded toward the new frame, so a still picture settles on its own colors
+        Simd::Average(in, last, last, SCREEN_WIDTH);
+        in = last;
+    }
+
+    if (in != out)
+        std::memcpy(out, in, SCREEN_WIDTH * sizeof(u32));
+}
+
+// one source line to factor output lines
+void PostProcess::Scale(const u32 *src, int line, u32 *out, int pitch)
+{
+    const u32 *row   = src + line * SCREEN_WIDTH;
+    const u32 *above = line > 0                 ? row - SCREEN_WIDTH : row;
+    const u32 *below = line < SCREEN_HEIGHT - 1 ? row + SCREEN_WIDTH : row;
+
+    u32 *dst = out + line * factor * pitch;
+
+    switch (config.scaler)
+    {
+        case Scaler::Nearest:
+            Simd::RepeatPixels(row, dst, SCREEN_WIDTH, factor);
+
+            for (int i = 1; i < factor; ++i)
+                std::memcpy(dst + i * pitch, dst, Width() * sizeof(u32));
+
+            break;
+
+        case Scaler::Scale2x: Simd::Scale2xLine(above, row, below, dst, dst + pitch, SCREEN_WIDTH); break;
+        case Scaler::Scale3x: Scale3xLine(src, line, out, pitch); break;
+        case Scaler::Xbr2x:   Xbr2xLine(src, line, out, pitch); break;
+        case Scaler::None:    break;
+    }
+}
+
+// AdvMAME3x
+//  A B C       E0 E1 E2
+//  D E F  ->   E3 E4 E5
+//  G H I       E6 E7 E8
+void PostProcess::Scale3xLine(const u32 *src, int line, u32 *out, int pitch)
+{
+    const u32 *row   = src + line * SCREEN_WIDTH;
+    const u32 *above = line > 0                 ? row - SCREEN_WIDTH : row;
+    const u32 *below = line < SCREEN_HEIGHT - 1 ? row + SCREEN_WIDTH : row;
+
+    u32 *out0 = out + line * 3 * pitch;
+    u32 *out1 = out0 + pitch;
+    u32 *out2 = out1 + pitch;
+
+    for (int x = 0; x < SCREEN_WIDTH; ++x)
+    {
+        int l = x > 0 ? x - 1 : x;
+        int r = x < SCREEN_WIDTH - 1 ? x + 1 : x;
+
+        u32 a = above[l], b = above[x], c = above[r];
+        u32 d = row[l],   e = row[x],   f = row[r];
+        u32 g = below[l], h = below[x], i = below[r];
+
+        u32 *o0 = out0 + x * 3, *o1 = out1 + x * 3, *o2 = out2 + x * 3;
+
+        if (b != h && d != f)
+        {
+            o0[0] = d == b ? d : e;
+            o0[1] = (d == b && e != c) || (b == f && e != a) ? b : e;
+            o0[2] = b == f ? f : e;
+            o1[0] = (d == b && e != g) || (d == h && e != a) ? d : e;
+            o1[1] = e;
+            o1[2] = (b == f && e != i) || (h == f && e != c) ? f : e;
+            o2[0] = d == h ? d : e;
+            o2[1] = (d == h && e != i) || (h == f && e != g) ? h : e;
+            o2[2] = h == f ? f : e;
+        }
+
+        else
+            o0[0] = o0[1] = o0[2] = o1[0] = o1[1] = o1[2] = o2[0] = o2[1] = o2[2] = e;
+    }
+}
+
+// move dst weight / 256 of the way to src, per channel
+static inline void Blend(u32 &dst, u32 src, int weight)
+{
+    u32 result = 0;
+
+    for (int shift = 0; shift < 24; shift += 8)
+    {
+        int d = dst >> shift & 0xFF, s = src >> shift & 0xFF;
+        result |= (u32) (d + ((s - d) * weight >> 8)) << shift;
+    }
+
+    dst = result;
+}
+
+// 2xBR level 1, after Hyllian's xBR. Neighborhood of E, clamped at the frame's edges:
+//        A1 B1 C1
+//     A0 A  B  C  C4
+//     D0 D  E  F  F4       E0 E1
+//     G0 G  H  I  I4       E2 E3
+//        G5 H5 I5
+// Each corner of E looks for an edge across it by weighing color differences along and
+// across the two diagonals, and blends toward the closer neighbor if there is one. The
+// four corners are the same test rotated, written out for E3 and remapped for the rest.
+void PostProcess::Xbr2xLine(const u32 *src, int line, u32 *out, int pitch)
+{
+    enum { A1, B1, C1, A0, A, B, C, C4, D0, D, E, F, F4, G0, G, H, I, I4, G5, H5, I5, NUM };
+
+    static constexpr int offsets[NUM][2] =
+    {
+                  {-1, -2}, { 0, -2}, { 1, -2},
+        {-2, -1}, {-1, -1}, { 0, -1}, { 1, -1}, { 2, -1},
+        {-2,  0}, {-1,  0}, { 0,  0}, { 1,  0}, { 2,  0},
+        {-2,  1}, {-1,  1}, { 0,  1}, { 1,  1}, { 2,  1},
+                  {-1,  2}, { 0,  2}, { 1,  2},
+    };
+
+    // E, I, H, F, G, C, D, B, F4, I4, H5, I5 and the output corners N1, N2, N3 for each rotation
+    static constexpr int rotations[4][15] =
+    {
+        { E, I, H, F, G, C, D, B, F4, I4, H5, I5, 1, 2, 3 },
+        { E, C, F, B, I, A, H, D, B1, C1, F4, C4, 0, 3, 1 },
+        { E, A, B, D, C, G, F, H, D0, A0, B1, A1, 2, 1, 0 },
+        { E, G, D, H, A, I, B, F, H5, G5, D0, G0, 3, 0, 2 },
+    };
+
+    u32 *out0 = out + line * 2 * pitch;
+    u32 *out1 = out0 + pitch;
+
+    int rows[5];
+    for (int dy = -2; dy <= 2; ++dy)
+        rows[dy + 2] = std::clamp(line + dy, 0, SCREEN_HEIGHT - 1) * SCREEN_WIDTH;
+
+    for (int x = 0; x < SCREEN_WIDTH; ++x)
+    {
+        u32 p[NUM], y[NUM];
+
+        for (int n = 0; n < NUM; ++n)
+        {
+            int index = rows[offsets[n][1] + 2] + std::clamp(x + offsets[n][0], 0, SCREEN_WIDTH - 1);
+            p[n] = src[index];
+            y[n] = yuv[index];
+        }
+
+        // weighted yuv distance, and hqx's thresholds for "same color"
+        auto df = [&](int a, int b)
+        {
+            return 48 * std::abs((int) (y[a] >> 16) - (int) (y[b] >> 16))
+                 +  7 * std::abs((int) (y[a] >> 8 & 0xFF) - (int) (y[b] >> 8 & 0xFF))
+                 +  6 * std::abs((int) (y[a] & 0xFF) - (int) (y[b] & 0xFF));
+        };
+
+        auto eq = [&](int a, int b)
+        {
+            return std::abs((int) (y[a] >> 16) - (int) (y[b] >> 16)) < 48
+                && std::abs((int) (y[a] >> 8 & 0xFF) - (int) (y[b] >> 8 & 0xFF)) < 7
+                && std::abs((int) (y[a] & 0xFF) - (int) (y[b] & 0xFF)) < 6;
+        };
+
+        u32 e[4] = { p[E], p[E], p[E], p[E] };
+
+        for (auto &rot : rotations)
+        {
+            int pe = rot[0], pi = rot[1], ph = rot[2], pf = rot[3], pg = rot[4], pc = rot[5], pd = rot[6], pb = rot[7];
+            int f4 = rot[8], i4 = rot[9], h5 = rot[10], i5 = rot[11];
+            int n1 = rot[12], n2 = rot[13], n3 = rot[14];
+
+            if (p[pe] == p[ph] || p[pe] == p[pf])
+                continue;
+
+            int along  = df(pe, pc) + df(pe, pg) + df(pi, h5) + df(pi, f4) + 4 * df(ph, pf);
+            int across = df(ph, pd) + df(ph, i5) + df(pf, i4) + df(pf, pb) + 4 * df(pe, pi);
+
+            u32 px = df(pe, pf) <= df(pe, ph) ? p[pf] : p[ph];
+
+            if (along < across && ((!eq(pf, pb) && !eq(ph, pd)) || (eq(pe, pi) && !eq(pf, i4) && !eq(ph, i5)) || eq(pe, pg) || eq(pe, pc)))
+            {
+                int ke = df(pf, pg), ki = df(ph, pc);
+                bool ex2 = p[pe] != p[pc] && p[pb] != p[pc];
+                bool ex3 = p[pe] != p[pg] && p[pd] != p[pg];
+
+                // shallow and steep edges cover more than the corner
+                if (2 * ke <= ki && ex3 && ke >= 2 * ki && ex2)
+                {
+                    Blend(e[n3], px, 224);
+                    Blend(e[n2], px, 64);
+                    e[n1] = e[n2];
+                }
+
+                else if (2 * ke <= ki && ex3)
+                {
+                    Blend(e[n3], px, 192);
+                    Blend(e[n2], px, 64);
+                }
+
+                else if (ke >= 2 * ki && ex2)
+                {
+                    Blend(e[n3], px, 192);
+                    Blend(e[n1], px, 64);
+                }
+
+                else
+                    Blend(e[n3], px, 128);
+            }
+
+            else if (along <= across)
+                Blend(e[n3], px, 128);
+        }
+
+        out0[x * 2] = e[0];
+        out0[x * 2 + 1] = e[1];
+        out1[x * 2] = e[2];
+        out1[x * 2 + 1] = e[3];
+    }
+}
+
+// the gba's lcd is dark and its colors bleed into each other, after byuu's model of it
+void PostProcess::BuildLcdLut()
+{
+    constexpr double lcd_gamma = 4.0, out_gamma = 2.2;
+
+    lut.resize(32 * 32 * 32);
+
+    for (int r = 0; r < 32; ++r)
+    for (int g = 0; g < 32; ++g)
+    for (int b = 0; b < 32; ++b)
+    {
+        double lr = std::pow(r / 31.0, lcd_gamma);
+        double lg = std::pow(g / 31.0, lcd_gamma);
+        double lb = std::pow(b / 31.0, lcd_gamma);
+
+        auto channel = [&](double mixed) { return (u32) std::lround(std::pow(mixed / 255, 1 / out_gamma) * 255 * 255 / 280); };
+
+        u32 red   = channel(255 * lr +  50 * lg +   0 * lb);
+        u32 green = channel( 10 * lr + 230 * lg +  30 * lb);
+        u32 blue  = channel( 50 * lr +  10 * lg + 220 * lb);
+
+        lut[r << 10 | g << 5 | b] = red << 16 | green << 8 | blue;
+    }
+}
@@ -0,0 +1,66 @@
+/* discovery
+ * License: GPLv2
+ * See LICENSE.txt for full license text
+ *
+ * FILE: Presenter.cpp
+ * DATE: October 19th, 2026
+ * DESCRIPTION: takes finished frames from the ppu's swap chain and presents them, on a thread of its own
+ */
+
+#include <cstring>
+
+#include "Presenter.h"
+#include "ShmExport.h"
+
+Presenter::Presenter(PPU *ppu) : ppu(ppu)
+{
+    std::memset(shown_hashes, 0, sizeof(shown_hashes));
+
+    repaint = true;
+    stats   = 0;
+}
+
+Presenter::~Presenter() { }
+
+void Presenter::StartShmExport(const std::string &name)
+{
+    shm = std::make_unique<ShmExport>(name, ppu->Sink().Format());
+}
+
+bool Presenter::Present()
+{
+    Frame frame;
+
+    if (!ppu->AcquireFrame(frame))
+        return false;
+
+    damage.count = 0;
+
+    // the first frame has nothing to compare against
+    for (int line = 0; line < SCREEN_HEIGHT; ++line)
+    {
+        damage.dirty[line] = repaint || frame.hashes[line] != shown_hashes[line];
+        damage.count      += damage.dirty[line];
+    }
+
+    repaint = false;
+    std::memcpy(shown_hashes, frame.hashes, sizeof(shown_hashes));
+
+    // before the sink, the frame is in the swap chain's own memory rather than anything the sink may touch
+    if (shm)
+        shm->Publish(frame.pixels, SCREEN_WIDTH * BytesPerPixel(ppu->Sink().Format()), frame.hashes, damage, frame.number, frame.keys);
+
+    ppu->Sink().Present(frame.pixels, damage);
+
+    double fps;
+    u32 lag;
+    u32 count = ppu->Stats(fps, lag);
+
+    if (count != stats)
+    {
+        stats = count;
+        ppu->Sink().ShowStats(fps, lag);
+    }
+
+    return true;
+}
@@ -0,0 +1,233 @@
+/* discovery
+ * License: GPLv2
+ * See LICENSE.txt for full license text
+ *
+ * FILE: RenderThread.cpp
+ * DATE: October 19th, 2026
+ * DESCRIPTION: worker thread that draws frames from snapshots of the ppu's state
+ */
+
+#include <cstring>
+#include <utility>
+
+#include "RenderThread.h"
+
+RenderThread::RenderThread(Memory *mem, int threads, PixelFormat format, TripleBuffer *frames, bool lossless)
+    : mem(mem), frames(frames), lossless(lossless), renderer(&tiles, &palette, &objs, threads)
+{
+    for (int i = 0; i < NUM_SLOTS; ++i)
+    {
+        free_slots[i]  = i;
+        slots[i].writes = &logs[i];
+    }
+
+    num_free = NUM_SLOTS;
+
+    // the worker starts from video memory as it is now, and is kept up to date from the log after that
+    recording = &logs[NUM_SLOTS];
+    mem->video_writes = recording;
+
+    std::memcpy(vram, &mem->memory[MEM_VRAM_START],        sizeof(vram));
+    std::memcpy(pram, &mem->memory[MEM_PALETTE_RAM_START], sizeof(pram));
+    std::memcpy(oam,  &mem->memory[MEM_OAM_START],         sizeof(oam));
+
+    tiles.vram   = vram;
+    palette.pram = pram;
+    objs.oam     = oam;
+
+    // frames come out in the sink's format like the ppu's own
+    palette.SetFormat(format);
+
+    running = true;
+    worker  = std::thread(&RenderThread::Run, this);
+}
+
+RenderThread::~RenderThread()
+{
+    mem->video_writes = NULL;
+
+    // frames still queued are drawn and published without waiting on a consumer that's gone,
+    // this thread is the consumer now, taking the one the worker may be waiting on
+    running = false;
+    frames->Acquire();
+
+    // can't fail, there are more queue entries than slots
+    pending.Push(-1);
+    worker.join();
+}
+
+void RenderThread::Queue(const ScanlineLog &lines, u64 n, u16 keys)
+{
+    int slot;
+
+    // slots the worker is done with
+    while (done.Pop(slot))
+        free_slots[num_free++] = slot;
+
+    // every slot is in flight, wait for the worker to finish one
+    while (num_free == 0)
+    {
+        if (done.Pop(slot))
+            free_slots[num_free++] = slot;
+        else
+            done.WaitForItem();
+    }
+
+    Slot &next = slots[free_slots[--num_free]];
+
+    next.lines  = lines;
+    next.number = n;
+    next.keys   = keys;
+
+    // the frame's writes go with it, the next frame's into the log the slot had
+    std::swap(next.writes, recording);
+    recording->Clear();
+    mem->video_writes = recording;
+
+    next.snapshot = next.writes->Overflowed();
+
+    if (next.snapshot)
+    {
+        std::memcpy(next.vram, &mem->memory[MEM_VRAM_START],        sizeof(next.vram));
+        std::memcpy(next.pram, &mem->memory[MEM_PALETTE_RAM_START], sizeof(next.pram));
+        std::memcpy(next.oam,  &mem->memory[MEM_OAM_START],         sizeof(next.oam));
+    }
+
+    // can't fail, there are more queue entries than slots
+    pending.Push(&next - slots);
+}
+
+void RenderThread::Skip()
+{
+    recording->Settle();
+}
+
+void RenderThread::Run()
+{
+    int slot;
+    int pitch = SCREEN_WIDTH * BytesPerPixel(palette.Format());
+
+    for (;;)
+    {
+        if (!pending.Pop(slot))
+        {
+            pending.WaitForItem();
+            continue;
+        }
+
+        // shutting down
+        if (slot < 0)
+            break;
+
+        if (slots[slot].snapshot)
+        {
+            Merge(slots[slot]);
+            renderer.DrawFrame(slots[slot].lines, frames->Back(), pitch, frames->BackHashes());
+        }
+
+        else
+            Replay(slots[slot], frames->Back(), pitch, frames->BackHashes());
+
+        // a recording sink gets every frame, the consumer takes the last one before this replaces it
+        if (lossless && running)
+            frames->WaitTaken();
+
+        frames->Publish(slots[slot].number, slots[slot].keys);
+        done.Push(slot);
+    }
+}
+
+// draw a frame, applying its video memory writes between the lines as the cycle ppu saw them
+void RenderThread::Replay(const Slot &slot, void *screen, int pitch, u64 *hashes)
+{
+    const VideoWriteLog &log = *slot.writes;
+    const VideoWriteLog::Run *runs = log.Runs();
+    u32 num_runs = log.NumRuns();
+    u32 i = 0;
+
+    int line = 0;
+    while (line < SCREEN_HEIGHT)
+    {
+        while (i < num_runs && (int) runs[i].line <= line)
+            Apply(runs[i++], log.Data());
+
+        // lines up to the next write are drawn in one go
+        int next = i < num_runs ? runs[i].line : SCREEN_HEIGHT;
+        renderer.DrawLines(slot.lines, line, next, screen, pitch, hashes);
+        line = next;
+    }
+
+    // written after the last line, the next frame starts from them
+    while (i < num_runs)
+        Apply(runs[i++], log.Data());
+}
+
+void RenderThread::Apply(const VideoWriteLog::Run &run, const u8 *data)
+{
+    data += run.data;
+
+    for (u32 i = 0; i < run.length; ++i)
+    {
+        u32 address = run.address + i;
+
+        // Write8Unsafe doesn't mirror, anything outside the regions is no video memory the ppu reads
+        switch (address >> 24)
+        {
+            case 0x5:
+                if (address - MEM_PALETTE_RAM_START < sizeof(pram))
+                {
+                    pram[address - MEM_PALETTE_RAM_START] = data[i];
+                    palette.Invalidate(address - MEM_PALETTE_RAM_START);
+                }
+                break;
+
+            case 0x6:
+                if (address - MEM_VRAM_START < sizeof(vram))
+                {
+                    vram[address - MEM_VRAM_START] = data[i];
+                    tiles.Invalidate(address - MEM_VRAM_START);
+                }
+                break;
+
+            case 0x7:
+                if (address - MEM_OAM_START < sizeof(oam))
+                {
+                    oam[address - MEM_OAM_START] = data[i];
+                    objs.Invalidate(address - MEM_OAM_START);
+                }
+                break;
+        }
+    }
+}
+// bring the worker's video memory up to date with a slot, invalidating only what changed
+void RenderThread::Merge(const Slot &slot)
+{
+    // one TileCache block at a time
+    for (u32 offset = 0; offset < sizeof(vram); offset += 32)
+    {
+        if (std::memcmp(&vram[offset], &slot.vram[offset], 32) != 0)
+        {
+            std::memcpy(&vram[offset], &slot.vram[offset], 32);
+            tiles.Invalidate(offset);
+        }
+    }
+
+    // one color / OAM halfword at a time
+    for (u32 offset = 0; offset < sizeof(pram); offset += 2)
+    {
+        if (std::memcmp(&pram[offset], &slot.pram[offset], 2) != 0)
+        {
+            std::memcpy(&pram[offset], &slot.pram[offset], 2);
+            palette.Invalidate(offset);
+        }
+    }
+
+    for (u32 offset = 0; offset < sizeof(oam); offset += 2)
+    {
+        if (std::memcmp(&oam[offset], &slot.oam[offset], 2) != 0)
+        {
+            std::memcpy(&oam[offset], &slot.oam[offset], 2);
+            objs.Invalidate(offset);
+        }
+    }
+}
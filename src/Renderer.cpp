@@ -0,0 +1,628 @@
+/* discovery
+ * License: GPLv2
+ * See LICENSE.txt for full license text
+ *
+ * FILE: Renderer.cpp
+ * DATE: October 19th, 2026
+ * DESCRIPTION: scanline drawing, split out of the ppu so it can run away from the cpu timeline
+ */
+
+#include <cstring>
+#include <algorithm>
+
+#include "Renderer.h"
+#include "Simd.h"
+#include "FrameDamage.h"
+
+Renderer::Renderer(TileCache *tiles, PaletteCache *palette, OamCache *objs) : tiles(tiles), palette(palette), objs(objs)
+{
+    Reset();
+}
+
+void Renderer::Reset()
+{
+    std::memset(obj_bin_count, 0, sizeof(obj_bin_count));
+    bins_generation = 0; // OamCache generations start at 1
+}
+
+void Renderer::DrawFrame(const ScanlineLog &log, void *screen, int pitch, u64 *hashes)
+{
+    for (int line = 0; line < SCREEN_HEIGHT; ++line)
+        hashes[line] = DrawLine(log, line, (u8 *) screen + line * pitch);
+}
+
+u64 Renderer::DrawLine(const ScanlineLog &log, int line, void *out)
+{
+    this->log = &log;
+    regs      = &log.Regs(line);
+    scanline  = line;
+
+    // forced blank draws white
+    if (regs->dispcnt.fb)
+    {
+        switch (palette->Format())
+        {
+            case PixelFormat::XRGB8888: return Fill<PixelFormat::XRGB8888>(out);
+            case PixelFormat::RGB565:   return Fill<PixelFormat::RGB565>(out);
+            case PixelFormat::BGRA8888: return Fill<PixelFormat::BGRA8888>(out);
+            case PixelFormat::BGR555:   return Fill<PixelFormat::BGR555>(out);
+        }
+    }
+
+    // decode the OAM entries and matrices written since the last scanline, and re-bin the
+    // sprites if any entry changed, which also picks up mid-frame changes
+    objs->Refresh();
+
+    if (bins_generation != objs->generation)
+        BinObjs();
+
+    // convert palette entries written since the last scanline
+    palette->Refresh();
+
+    layers_drawn = 0;
+
+    switch (regs->dispcnt.mode)
+    {
+        case 0: // reg bg 0-3
+            for (int i = 3; i >= 0; --i) // bg0 - bg3
+            {
+                if (regs->bgcnt[i].enabled)
+                    RenderScanlineText(i);
+            }
+
+            break;
+        case 1: // reg bg 0-1, aff bg 2
+            if (regs->bgcnt[2].enabled) RenderScanlineAffine(2);
+            if (regs->bgcnt[1].enabled) RenderScanlineText(1);
+            if (regs->bgcnt[0].enabled) RenderScanlineText(0);
+
+            break;
+        case 2: // aff bg 2-3
+            if (regs->bgcnt[3].enabled) RenderScanlineAffine(3);
+            if (regs->bgcnt[2].enabled) RenderScanlineAffine(2);
+
+            break;
+        case 3:
+        case 4:
+        case 5:
+            RenderScanlineBitmap(regs->dispcnt.mode);
+            break;
+    }
+
+    if (regs->dispcnt.obj_enabled)
+        RenderScanlineObj();
+
+    switch (palette->Format())
+    {
+        case PixelFormat::XRGB8888: return Composite<PixelFormat::XRGB8888>(out);
+        case PixelFormat::RGB565:   return Composite<PixelFormat::RGB565>(out);
+        case PixelFormat::BGRA8888: return Composite<PixelFormat::BGRA8888>(out);
+        case PixelFormat::BGR555:   return Composite<PixelFormat::BGR555>(out);
+    }
+
+    return 0;
+}
+
+// clear bg's line buffer and return the attribute bits for its pixels
+u32 Renderer::BeginLayer(int bg)
+{
+    std::memset(layers[bg], 0, sizeof(layers[bg]));
+    layers_drawn |= 1 << bg;
+
+    return LAYER_OPAQUE | regs->bgcnt[bg].priority << LAYER_PRIORITY_SHIFT;
+}
+
+// pick the RenderScanlineText specialization for this bg's color mode and map size
+void Renderer::RenderScanlineText(int bg)
+{
+    auto const &bgcnt = regs->bgcnt[bg];
+
+    switch (bgcnt.color_mode << 2 | bgcnt.size)
+    {
+        case 0: RenderScanlineText<false, 0>(bg); break;
+        case 1: RenderScanlineText<false, 1>(bg); break;
+        case 2: RenderScanlineText<false, 2>(bg); break;
+        case 3: RenderScanlineText<false, 3>(bg); break;
+        case 4: RenderScanlineText<true,  0>(bg); break;
+        case 5: RenderScanlineText<true,  1>(bg); break;
+        case 6: RenderScanlineText<true,  2>(bg); break;
+        case 7: RenderScanlineText<true,  3>(bg); break;
+    }
+}
+
+// render the current scanline of a text bg one tile (8 px) at a time
+template <bool color_8bpp, int size>
+void Renderer::RenderScanlineText(int bg)
+{
+    auto const &bgcnt = regs->bgcnt[bg];
+
+    // width, height of map in pixels & pitch of screenblocks
+    constexpr int width  = size & 1 ? 512 : 256;
+    constexpr int height = size & 2 ? 512 : 256;
+    constexpr int pitch  = size == 3 ? 2 : size == 2 ? 1 : 0;
+
+    // map position
+    int map_y = (scanline + bgcnt.voff) % height;
+    int map_x = bgcnt.hoff % width;
+
+    // tile coordinates (in map)
+    int tile_y = map_y / 8; // 8 px per tile
+    int grid_y = map_y % 8;
+
+    u32 charblock = bgcnt.cbb * CHARBLOCK_LEN;
+    u32 attr = BeginLayer(bg);
+    u32 *line = layers[bg];
+
+    // the first tile starts up to 7 px left of the screen (fine scroll)
+    int x = -(map_x % 8);
+    map_x -= map_x % 8;
+
+    for (; x < SCREEN_WIDTH; x += 8, map_x = (map_x + 8) % width)
+    {
+        int tile_x = map_x / 8;
+
+        int screenblock = bgcnt.sbb + ((tile_y / 32) * pitch + (tile_x / 32));
+        int se_index    = screenblock * 1024 + (tile_y % 32) * 32 + (tile_x % 32);
+
+        u16 screenentry = tiles->vram[2 * se_index] | tiles->vram[2 * se_index + 1] << 8;
+        int tile_id = screenentry >>  0 & 0x3FF;
+        bool hflip  = screenentry >> 10 & 0x1;
+        bool vflip  = screenentry >> 11 & 0x1;
+
+        int row_y = vflip ? 7 - grid_y : grid_y;
+
+        // hflip picks the mirrored copy of the row
+        const u8 *row;
+        int palbank = 0;
+
+        if constexpr (color_8bpp)
+        {
+            row = tiles->Row8BPP(charblock + 0x40 * tile_id, row_y, hflip);
+        }
+
+        else
+        {
+            row = tiles->Row4BPP(charblock + 0x20 * tile_id, row_y, hflip);
+            palbank = (screenentry >> 12 & 0xF) * 16;
+        }
+
+        // clip the partial tiles at either edge of the screen
+        int start = x < 0 ? -x : 0;
+        int end   = x > SCREEN_WIDTH - 8 ? SCREEN_WIDTH - x : 8;
+
+        for (int i = start; i < end; ++i)
+        {
+            // palette index 0 is transparent
+            if (row[i] != 0)
+                line[x + i] = palette->BG(row[i] + palbank) | attr;
+        }
+    }
+}
+
+// render the current scanline for affine bg modes
+// texels are looked up by the kernels in Simd.cpp, starting from the internal reference point
+void Renderer::RenderScanlineAffine(int bg)
+{
+    auto const &bgcnt = regs->bgcnt[bg];
+
+    // maps are square, 128 - 1024 px
+    int size = 128 << bgcnt.size;
+
+    const u8 *vram = tiles->vram;
+    u8 indices[SCREEN_WIDTH];
+
+    Simd::AffineLine(vram + bgcnt.sbb * SCREENBLOCK_LEN, vram + bgcnt.cbb * CHARBLOCK_LEN, size, bgcnt.affine_wrap,
+                     log->RefX(scanline, bg - 2), log->RefY(scanline, bg - 2), regs->pa[bg - 2], regs->pc[bg - 2],
+                     indices, SCREEN_WIDTH);
+
+    u32 attr = BeginLayer(bg);
+    u32 *line = layers[bg];
+
+    for (int x = 0; x < SCREEN_WIDTH; ++x)
+    {
+        // palette index 0 is transparent
+        if (indices[x] != 0)
+            line[x] = palette->BG(indices[x]) | attr;
+    }
+}
+
+// render the current scanline for bitmap modes
+// rows are converted straight out of VRAM by the kernels in Simd.cpp
+void Renderer::RenderScanlineBitmap(int mode)
+{
+    const u8 *vram = tiles->vram;
+    u32 *line = layers[2]; // bitmap modes draw on bg2
+    int width = SCREEN_WIDTH;
+
+    u32 attr = BeginLayer(2);
+
+    switch (mode)
+    {
+        case 3:
+            // the vector kernel converts to xrgb8888, other formats go through the palette cache's table
+            if (palette->Format() == PixelFormat::XRGB8888)
+                Simd::ConvertBGR555(vram + scanline * SCREEN_WIDTH * sizeof(u16), line, SCREEN_WIDTH);
+            else
+            {
+                const u8 *row = vram + scanline * SCREEN_WIDTH * sizeof(u16);
+
+                for (int x = 0; x < SCREEN_WIDTH; ++x)
+                    line[x] = palette->Direct(row[x * 2] | row[x * 2 + 1] << 8);
+            }
+
+            break;
+        
+        case 4:
+            // page 2 starts at 0x600A000
+            if (regs->dispcnt.ps)
+                vram += 0xA000;
+
+            Simd::GatherPalette(vram + scanline * SCREEN_WIDTH, palette->BGColors(), line, SCREEN_WIDTH);
+            break;
+        
+        case 5:
+            if (scanline >= 128) return; // mode 5 has 160 x 128 resolution
+
+            // page 2 starts at 0x600A000
+            if (regs->dispcnt.ps)
+                vram += 0xA000;
+
+            Simd::GatherPalette(vram + scanline * 160, palette->BGColors(), line, 160);
+            width = 160;
+            break;
+    }
+
+    for (int x = 0; x < width; ++x)
+        line[x] |= attr;
+}
+
+// render the sprites binned on the current scanline into the OBJ layer
+void Renderer::RenderScanlineObj()
+{
+    const OamCache &objs = *this->objs;
+    u32 *line = layers[LAYER_OBJ];
+
+    std::memset(line, 0, sizeof(layers[LAYER_OBJ]));
+    std::memset(obj_window, 0, sizeof(obj_window));
+    layers_drawn |= 1 << LAYER_OBJ;
+
+    // bins are in OAM order, and the lowest OAM index wins between sprites of the same priority
+    for (int n = 0; n < obj_bin_count[scanline]; ++n)
+    {
+        int i = obj_bins[scanline][n];
+
+        u32 pixel_attr = LAYER_OPAQUE | objs.priority[i] << LAYER_PRIORITY_SHIFT;
+        if (objs.gfx_mode[i] == 1)
+            pixel_attr |= LAYER_SEMI_TRANSPARENT;
+
+        // row of the sprite on this scanline, relative to its center
+        int iy = scanline - objs.y[i];
+
+        // span of the sprite on screen, clipped once here instead of per pixel
+        int left  = objs.x[i] - objs.hwidth[i];
+        int start = std::max(left, 0);
+        int end   = std::min(objs.x[i] + objs.hwidth[i], SCREEN_WIDTH);
+
+        int width  = objs.width[i];
+        int height = objs.height[i];
+
+        bool affine = objs.obj_mode[i] == 1 || objs.obj_mode[i] == 3;
+
+        // row of the texture for regular sprites
+        int py = objs.v_flip[i] ? objs.hheight[i] - iy - 1 : objs.hheight[i] + iy;
+
+        // 8.8 fixed point texture coordinate of the first pixel for affine sprites, stepped by pa, pc
+        s32 tx = 0, ty = 0, pa = 0, pc = 0;
+        if (affine)
+        {
+            int m  = objs.affine_index[i];
+            int ix = start - objs.x[i];
+
+            pa = objs.pa[m];
+            pc = objs.pc[m];
+            tx = pa * ix + objs.pb[m] * iy + (width  / 2 << 8);
+            ty = pc * ix + objs.pd[m] * iy + (height / 2 << 8);
+        }
+
+        for (int x = start; x < end; ++x, tx += pa, ty += pc)
+        {
+            int px;
+
+            if (affine)
+            {
+                px = tx >> 8;
+                py = ty >> 8;
+
+                // outside the texture is transparent
+                if ((u32) px >= (u32) width || (u32) py >= (u32) height)
+                    continue;
+            }
+
+            else
+            {
+                px = objs.h_flip[i] ? width - (x - left) - 1 : x - left;
+            }
+
+            int palette_index = ObjTexel(i, px, py);
+
+            if (palette_index == 0)
+                continue;
+
+            // obj window sprites aren't drawn, they only mark where the window is
+            if (objs.gfx_mode[i] == 2)
+            {
+                obj_window[x] = true;
+                continue;
+            }
+
+            // an earlier sprite keeps the pixel unless this one has a higher priority
+            if (!(line[x] & LAYER_OPAQUE) || objs.priority[i] < (line[x] >> LAYER_PRIORITY_SHIFT & 0x3))
+                line[x] = palette->OBJ(palette_index) | pixel_attr;
+        }
+    }
+}
+
+// OBJ palette index of texel (px, py) of sprite i, 0 if transparent
+int Renderer::ObjTexel(int i, int px, int py)
+{
+    const OamCache &objs = *this->objs;
+
+    int tile_x  = px % 8; // x coordinate of pixel within tile
+    int tile_y  = py % 8; // y coordinate of pixel within tile
+    int block_x = px / 8; // x coordinate of tile in vram
+    int block_y = py / 8; // y coordinate of tile in vram
+
+    int tileno = objs.tileno[i];
+
+    if (objs.color_mode[i] == 1) // 8bpp
+    {
+        if (regs->dispcnt.obj_map_mode == 1) // 1d
+            tileno += block_y * (objs.width[i] / 4);
+        else // 2d
+            tileno = (tileno & ~1) + block_y * 32;
+
+        tileno += block_x * 2;
+
+        return tiles->Row8BPP(LOWER_SPRITE_BLOCK - MEM_VRAM_START + tileno * 32, tile_y, false)[tile_x];
+    }
+
+    // 4bpp
+    if (regs->dispcnt.obj_map_mode == 1) // 1d
+        tileno += block_y * (objs.width[i] / 8);
+    else // 2d
+        tileno += block_y * 32;
+
+    tileno += block_x;
+
+    int palette_index = tiles->Row4BPP(LOWER_SPRITE_BLOCK - MEM_VRAM_START + tileno * 32, tile_y, false)[tile_x];
+
+    return palette_index == 0 ? 0 : palette_index + objs.palbank[i] * 16;
+}
+
+// sort the visible sprites into the scanlines they cover
+void Renderer::BinObjs()
+{
+    const OamCache &objs = *this->objs;
+
+    bins_generation = objs.generation;
+
+    for (int y = 0; y < SCREEN_HEIGHT; ++y)
+        obj_bin_count[y] = 0;
+
+    for (int i = 0; i < NUM_OBJS; ++i)
+    {
+        // skip hidden object
+        if (objs.obj_mode[i] == 2)
+            continue;
+
+        int top    = std::max(objs.y[i] - objs.hheight[i], 0);
+        int bottom = std::min(objs.y[i] + objs.hheight[i], SCREEN_HEIGHT);
+
+        for (int y = top; y < bottom; ++y)
+            obj_bins[y][obj_bin_count[y]++] = i;
+    }
+}
+
+// per channel color effects on host colors, 5 bits per channel as on hardware
+// Traits says where each format keeps its channels, see PixelFormat.h
+template <typename Traits>
+static inline u32 BlendAlpha(u32 top, u32 bottom, int eva, int evb)
+{
+    u32 result = 0;
+
+    for (int shift : { Traits::R, Traits::G, Traits::B })
+    {
+        u32 channel = ((top >> shift & 0x1F) * eva + (bottom >> shift & 0x1F) * evb) >> 4;
+        result |= (channel > 0x1F ? 0x1F : channel) << shift;
+    }
+
+    return result;
+}
+
+template <typename Traits>
+static inline u32 Brighten(u32 color, int evy)
+{
+    u32 result = 0;
+
+    for (int shift : { Traits::R, Traits::G, Traits::B })
+    {
+        u32 channel = color >> shift & 0x1F;
+        result |= (channel + (((0x1F - channel) * evy) >> 4)) << shift;
+    }
+
+    return result;
+}
+
+template <typename Traits>
+static inline u32 Darken(u32 color, int evy)
+{
+    u32 result = 0;
+
+    for (int shift : { Traits::R, Traits::G, Traits::B })
+    {
+        u32 channel = color >> shift & 0x1F;
+        result |= (channel - ((channel * evy) >> 4)) << shift;
+    }
+
+    return result;
+}
+
+// test whether [lo, hi) of a window register covers pos
+// hi > max or lo > hi are taken as hi = max, as on hardware
+static inline bool InWindow(int pos, int lo, int hi, int max)
+{
+    if (hi > max || lo > hi)
+        hi = max;
+
+    return pos >= lo && pos < hi;
+}
+
+// hash a finished line while it's on the stack, then write it out
+// out is often a lent texture, which may be write-combined and must never be read back
+template <typename Pixel>
+static inline u64 WriteLine(const Pixel (&line)[SCREEN_WIDTH], void *out)
+{
+    std::memcpy(out, line, sizeof(line));
+    return HashLine(line, sizeof(line));
+}
+
+// fill a line of out with forced blank white, return its HashLine
+template <PixelFormat format>
+u64 Renderer::Fill(void *out)
+{
+    using Pixel = typename PixelTraits<format>::Pixel;
+
+    alignas(64) Pixel line[SCREEN_WIDTH];
+    std::fill_n(line, SCREEN_WIDTH, PixelTraits<format>::WHITE);
+
+    return WriteLine(line, out);
+}
+
+// resolve the line buffers of the current scanline into out, SCREEN_WIDTH pixels in format, return its HashLine
+template <PixelFormat format>
+u64 Renderer::Composite(void *out)
+{
+    using Traits = PixelTraits<format>;
+    using Pixel  = typename Traits::Pixel;
+
+    u16 winin    = regs->winin;
+    u16 winout   = regs->winout;
+    u16 bldcnt   = regs->bldcnt;
+    u16 bldalpha = regs->bldalpha;
+    u16 bldy     = regs->bldy;
+
+    // per pixel layer / effect enable bits, in WININ order (bits 0-3 BG, 4 OBJ, 5 effects)
+    u8 window[SCREEN_WIDTH];
+
+    if (regs->dispcnt.win_enabled == 0)
+    {
+        std::memset(window, 0x3F, sizeof(window));
+    }
+
+    else
+    {
+        std::memset(window, winout & 0x3F, sizeof(window));
+
+        // obj window, then win1, then win0 on top
+        if (regs->dispcnt.win_enabled & 0b100 && layers_drawn & 1 << LAYER_OBJ)
+        {
+            for (int x = 0; x < SCREEN_WIDTH; ++x)
+                window[x] = obj_window[x] ? winout >> 8 & 0x3F : window[x];
+        }
+
+        for (int win = 1; win >= 0; --win)
+        {
+            if (!(regs->dispcnt.win_enabled >> win & 1))
+                continue;
+
+            u16 h = regs->winh[win];
+            u16 v = regs->winv[win];
+
+            if (!InWindow(scanline, v >> 8, v & 0xFF, SCREEN_HEIGHT))
+                continue;
+
+            u8 enable = winin >> (8 * win) & 0x3F;
+
+            for (int x = 0; x < SCREEN_WIDTH; ++x)
+                window[x] = InWindow(x, h >> 8, h & 0xFF, SCREEN_WIDTH) ? enable : window[x];
+        }
+    }
+
+    // top two visible layers of every pixel, starting from the backdrop
+    u32 top[SCREEN_WIDTH], bottom[SCREEN_WIDTH];
+    u8  top_id[SCREEN_WIDTH], bottom_id[SCREEN_WIDTH];
+
+    u32 backdrop = palette->BG(0);
+    for (int x = 0; x < SCREEN_WIDTH; ++x)
+    {
+        top[x]    = bottom[x]    = backdrop;
+        top_id[x] = bottom_id[x] = LAYER_BACKDROP;
+    }
+
+    // paint back to front: at each priority, bg3 - bg0 then sprites of that priority
+    for (int priority = 3; priority >= 0; --priority)
+    {
+        for (int layer = 3; layer >= -1; --layer)
+        {
+            int id = layer < 0 ? LAYER_OBJ : layer;
+
+            if (!(layers_drawn >> id & 1))
+                continue;
+
+            if (id != LAYER_OBJ && regs->bgcnt[id].priority != priority)
+                continue;
+
+            const u32 *line = layers[id];
+
+            for (int x = 0; x < SCREEN_WIDTH; ++x)
+            {
+                bool visible = (line[x] & LAYER_OPAQUE) && (window[x] >> id & 1) &&
+                               (int) (line[x] >> LAYER_PRIORITY_SHIFT & 0x3) == priority;
+
+                bottom[x]    = visible ? top[x]    : bottom[x];
+                bottom_id[x] = visible ? top_id[x] : bottom_id[x];
+                top[x]       = visible ? line[x]   : top[x];
+                top_id[x]    = visible ? id        : top_id[x];
+            }
+        }
+    }
+
+    // color special effects
+    int mode   = bldcnt >> 6 & 0x3;
+    int first  = bldcnt      & 0x3F;
+    int second = bldcnt >> 8 & 0x3F;
+
+    int eva = std::min(bldalpha      & 0x1F, 16);
+    int evb = std::min(bldalpha >> 8 & 0x1F, 16);
+    int evy = std::min(bldy          & 0x1F, 16);
+
+    alignas(64) Pixel line[SCREEN_WIDTH];
+
+    for (int x = 0; x < SCREEN_WIDTH; ++x)
+    {
+        u32 color = top[x] & 0xFFFFFF;
+
+        if (window[x] & 0x20)
+        {
+            bool blend_below = second >> bottom_id[x] & 1;
+
+            // semi-transparent sprites blend with whatever is below regardless of mode
+            if (top_id[x] == LAYER_OBJ && top[x] & LAYER_SEMI_TRANSPARENT && blend_below)
+                color = BlendAlpha<Traits>(color, bottom[x], eva, evb);
+
+            else if (first >> top_id[x] & 1)
+            {
+                switch (mode)
+                {
+                    case 1: if (blend_below) color = BlendAlpha<Traits>(color, bottom[x], eva, evb); break;
+                    case 2: color = Brighten<Traits>(color, evy); break;
+                    case 3: color = Darken<Traits>(color, evy);   break;
+                }
+            }
+        }
+
+        line[x] = color | Traits::ALPHA;
+    }
+
+    return WriteLine(line, out);
+}
@@ -0,0 +1,122 @@
+/* discovery
+ * License: GPLv2
+ * See LICENSE.txt for full license text
+ *
+ * FILE: ShmExport.cpp
+ * DATE: October 19th, 2026
+ * DESCRIPTION: publishes presented frames to a POSIX shared memory ring for local tools
+ */
+
+#include <cstring>
+#include <cerrno>
+#include <new>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "ShmExport.h"
+
+ShmExport::ShmExport(const std::string &name, PixelFormat format) : name(name)
+{
+    // shm_open wants one leading slash
+    if (this->name.empty() || this->name[0] != '/')
+        this->name = "/" + this->name;
+
+    line_bytes = SCREEN_WIDTH * BytesPerPixel(format);
+
+    u64 frames_offset = (sizeof(ShmHeader) + 4095) & ~4095ULL;
+    u32 frame_bytes   = line_bytes * SCREEN_HEIGHT;
+
+    size = frames_offset + (u64) frame_bytes * SHM_SLOTS;
+
+    // never take over an object someone else made, it may be another instance's live ring
+    int fd = shm_open(this->name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+
+    if (fd < 0 && errno == EEXIST)
+    {
+        LOG(LogLevel::Error, "Error: Shared memory {} already exists (another instance is using it, or it was left behind: rm /dev/shm{})\n", this->name, this->name);
+        exit(1);
+    }
+
+    if (fd < 0)
+    {
+        LOG(LogLevel::Error, "Error: Unable to create shared memory {}: {}\n", this->name, std::strerror(errno));
+        exit(1);
+    }
+
+    if (ftruncate(fd, size) != 0)
+    {
+        LOG(LogLevel::Error, "Error: Unable to size shared memory {}: {}\n", this->name, std::strerror(errno));
+        shm_unlink(this->name.c_str());
+        exit(1);
+    }
+
+    void *mapping = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+
+    if (mapping == MAP_FAILED)
+    {
+        LOG(LogLevel::Error, "Error: Unable to map shared memory {}: {}\n", this->name, std::strerror(errno));
+        shm_unlink(this->name.c_str());
+        exit(1);
+    }
+
+    // zeroes every slot's sequence, and magic until the rest is filled in
+    header = new (mapping) ShmHeader();
+    frames = (u8 *) mapping + frames_offset;
+
+    header->version       = SHM_VERSION;
+    header->width         = SCREEN_WIDTH;
+    header->height        = SCREEN_HEIGHT;
+    header->format        = (u32) format;
+    header->pitch         = line_bytes;
+    header->slots         = SHM_SLOTS;
+    header->frame_bytes   = frame_bytes;
+    header->frames_offset = frames_offset;
+
+    header->published.store(0, std::memory_order_release);
+    header->magic = SHM_MAGIC;
+
+    published = 0;
+    std::memset(filled, 0, sizeof(filled));
+}
+
+ShmExport::~ShmExport()
+{
+    // ours, O_EXCL made it; readers that still have it mapped keep their mapping, new ones can't open it
+    munmap(header, size);
+    shm_unlink(name.c_str());
+}
+
+void ShmExport::Publish(const void *pixels, int pitch, const u64 *hashes, const FrameDamage &damage, u64 frame, u16 keys)
+{
+    int index = published % SHM_SLOTS;
+
+    ShmSlot &slot = header->slot[index];
+    u8 *out = frames + (size_t) index * header->frame_bytes;
+
+    u32 sequence = slot.sequence.load(std::memory_order_relaxed);
+
+    // odd, readers of this slot retry or drop what they read
+    slot.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    // the slot holds the frame from SHM_SLOTS publishes ago, bring over only the lines that differ
+    for (int line = 0; line < SCREEN_HEIGHT; ++line)
+    {
+        if (filled[index] && slot_hashes[index][line] == hashes[line])
+            continue;
+
+        std::memcpy(out + line * line_bytes, (const u8 *) pixels + line * pitch, line_bytes);
+        slot_hashes[index][line] = hashes[line];
+    }
+
+    filled[index] = true;
+
+    slot.keys  = keys;
+    slot.frame = frame;
+    std::memcpy(slot.dirty, damage.dirty, sizeof(slot.dirty));
+
+    slot.sequence.store(sequence + 2, std::memory_order_release);
+    header->published.store(++published, std::memory_order_release);
+}
@@ -0,0 +1,552 @@
+/* discovery
+ * License: GPLv2
+ * See LICENSE.txt for full license text
+ *
+ * FILE: Simd.cpp
+ * DATE: October 19th, 2026
+ * DESCRIPTION: scalar, SSE2 and AVX2 versions of the scanline kernels
+ */
+
+#include "Simd.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SIMD_X86
+#endif
+
+// same conversion as PaletteCache::Direct
+static inline u32 BGR555ToHost(u16 color)
+{
+    return (color & 0x1F) << 19 | (color & 0x3E0) << 6 | (color & 0x7C00) >> 7;
+}
+
+static void ConvertBGR555Scalar(const u8 *src, u32 *dst, int count)
+{
+    for (int i = 0; i < count; ++i)
+        dst[i] = BGR555ToHost(src[i * 2] | src[i * 2 + 1] << 8);
+}
+
+static void GatherPaletteScalar(const u8 *src, const u32 *palette, u32 *dst, int count)
+{
+    for (int i = 0; i < count; ++i)
+        dst[i] = palette[src[i]];
+}
+
+static void AffineLineScalar(const u8 *map, const u8 *tiles, int size, bool wrap,
+                             s32 x, s32 y, s32 pa, s32 pc, u8 *dst, int count)
+{
+    for (int i = 0; i < count; ++i, x += pa, y += pc)
+    {
+        int tx = x >> 8;
+        int ty = y >> 8;
+
+        if (wrap)
+        {
+            tx &= size - 1;
+            ty &= size - 1;
+        }
+
+        // outside the map is transparent
+        else if ((u32) tx >= (u32) size || (u32) ty >= (u32) size)
+        {
+            dst[i] = 0;
+            continue;
+        }
+
+        // one byte per screen entry, 8bpp tiles
+        u8 tile = map[(ty >> 3) * (size >> 3) + (tx >> 3)];
+        dst[i] = tiles[tile * 64 + (ty & 7) * 8 + (tx & 7)];
+    }
+}
+
+static inline u32 Rgb555Index(u32 color)
+{
+    return (color >> 9 & 0x7C00) | (color >> 6 & 0x3E0) | (color >> 3 & 0x1F);
+}
+
+static void ColorLutScalar(const u32 *src, const u32 *lut, u32 *dst, int count)
+{
+    for (int i = 0; i < count; ++i)
+        dst[i] = lut[Rgb555Index(src[i])];
+}
+
+// per byte (a + b) / 2 rounded toward a
+static void AverageScalar(const u32 *a, const u32 *b, u32 *dst, int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        u32 average = 0;
+
+        for (int shift = 0; shift < 32; shift += 8)
+        {
+            u32 x = a[i] >> shift & 0xFF;
+            u32 y = b[i] >> shift & 0xFF;
+
+            average |= (x + y + (x > y)) >> 1 << shift;
+        }
+
+        dst[i] = average;
+    }
+}
+
+static void RgbToYuvScalar(const u32 *src, u32 *dst, int count)
+{
+    for (int i = 0; i < count; ++i)
+    {
+        int r = src[i] >> 16 & 0xFF, g = src[i] >> 8 & 0xFF, b = src[i] & 0xFF;
+
+        int y = ( 77 * r + 150 * g +  29 * b) >> 8;
+        int u = ((-43 * r -  85 * g + 128 * b) >> 8) + 128;
+        int v = ((128 * r - 107 * g -  21 * b) >> 8) + 128;
+
+        dst[i] = y << 16 | u << 8 | v;
+    }
+}
+
+static void RepeatPixelsScalar(const u32 *src, u32 *dst, int count, int n)
+{
+    for (int i = 0; i < count; ++i)
+        for (int j = 0; j < n; ++j)
+            *dst++ = src[i];
+}
+
+// pixels x0 - x1 of a Scale2x line, clamped to the line at its ends
+//    B          E0 E1
+//  D E F  ->    E2 E3
+//    H
+static void Scale2xRange(const u32 *above, const u32 *line, const u32 *below, u32 *out0, u32 *out1, int width, int x0, int x1)
+{
+    for (int x = x0; x < x1; ++x)
+    {
+        u32 b = above[x], e = line[x], h = below[x];
+        u32 d = line[x > 0 ? x - 1 : x];
+        u32 f = line[x < width - 1 ? x + 1 : x];
+
+        bool edge = b != h && d != f;
+
+        out0[x * 2]     = edge && d == b ? d : e;
+        out0[x * 2 + 1] = edge && b == f ? f : e;
+        out1[x * 2]     = edge && d == h ? d : e;
+        out1[x * 2 + 1] = edge && h == f ? f : e;
+    }
+}
+
+static void Scale2xLineScalar(const u32 *above, const u32 *line, const u32 *below, u32 *out0, u32 *out1, int width)
+{
+    Scale2xRange(above, line, below, out0, out1, width, 0, width);
+}
+
+#ifdef SIMD_X86
+
+// 8 pixels per iteration
+__attribute__((target("sse2")))
+static void ConvertBGR555SSE2(const u8 *src, u32 *dst, int count)
+{
+    const __m128i zero  = _mm_setzero_si128();
+    const __m128i mask_r = _mm_set1_epi32(0x001F);
+    const __m128i mask_g = _mm_set1_epi32(0x03E0);
+    const __m128i mask_b = _mm_set1_epi32(0x7C00);
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i pixels = _mm_loadu_si128((const __m128i *) (src + i * 2));
+
+        for (int half = 0; half < 2; ++half)
+        {
+            __m128i c = half ? _mm_unpackhi_epi16(pixels, zero) : _mm_unpacklo_epi16(pixels, zero);
+
+            __m128i r = _mm_slli_epi32(_mm_and_si128(c, mask_r), 19);
+            __m128i g = _mm_slli_epi32(_mm_and_si128(c, mask_g),  6);
+            __m128i b = _mm_srli_epi32(_mm_and_si128(c, mask_b),  7);
+
+            _mm_storeu_si128((__m128i *) (dst + i + half * 4), _mm_or_si128(r, _mm_or_si128(g, b)));
+        }
+    }
+
+    ConvertBGR555Scalar(src + i * 2, dst + i, count - i);
+}
+
+// 16 pixels per iteration
+__attribute__((target("avx2")))
+static void ConvertBGR555AVX2(const u8 *src, u32 *dst, int count)
+{
+    const __m256i mask_r = _mm256_set1_epi32(0x001F);
+    const __m256i mask_g = _mm256_set1_epi32(0x03E0);
+    const __m256i mask_b = _mm256_set1_epi32(0x7C00);
+
+    int i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        for (int half = 0; half < 2; ++half)
+        {
+            __m256i c = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *) (src + (i + half * 8) * 2)));
+
+            __m256i r = _mm256_slli_epi32(_mm256_and_si256(c, mask_r), 19);
+            __m256i g = _mm256_slli_epi32(_mm256_and_si256(c, mask_g),  6);
+            __m256i b = _mm256_srli_epi32(_mm256_and_si256(c, mask_b),  7);
+
+            _mm256_storeu_si256((__m256i *) (dst + i + half * 8), _mm256_or_si256(r, _mm256_or_si256(g, b)));
+        }
+    }
+
+    ConvertBGR555Scalar(src + i * 2, dst + i, count - i);
+}
+
+// sse2 has no gather, but 16 indices per load and unrolled lookups still beat the byte loop
+__attribute__((target("sse2")))
+static void GatherPaletteSSE2(const u8 *src, const u32 *palette, u32 *dst, int count)
+{
+    int i = 0;
+    for (; i + 16 <= count; i += 16)
+    {
+        alignas(16) u8 indices[16];
+        _mm_store_si128((__m128i *) indices, _mm_loadu_si128((const __m128i *) (src + i)));
+
+        for (int j = 0; j < 16; j += 4)
+        {
+            __m128i colors = _mm_set_epi32(palette[indices[j + 3]], palette[indices[j + 2]],
+                                           palette[indices[j + 1]], palette[indices[j + 0]]);
+            _mm_storeu_si128((__m128i *) (dst + i + j), colors);
+        }
+    }
+
+    GatherPaletteScalar(src + i, palette, dst + i, count - i);
+}
+
+__attribute__((target("avx2")))
+static void GatherPaletteAVX2(const u8 *src, const u32 *palette, u32 *dst, int count)
+{
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i indices = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *) (src + i)));
+        _mm256_storeu_si256((__m256i *) (dst + i), _mm256_i32gather_epi32((const int *) palette, indices, 4));
+    }
+
+    GatherPaletteScalar(src + i, palette, dst + i, count - i);
+}
+
+// 8 pixels per iteration, the map and tile lookups are byte gathers
+__attribute__((target("avx2")))
+static void AffineLineAVX2(const u8 *map, const u8 *tiles, int size, bool wrap,
+                           s32 x, s32 y, s32 pa, s32 pc, u8 *dst, int count)
+{
+    const __m256i lane   = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i bytes  = _mm256_set1_epi32(0xFF);
+    const __m256i seven  = _mm256_set1_epi32(7);
+    const __m256i limit  = _mm256_set1_epi32(size);
+    const __m256i mask   = _mm256_set1_epi32(size - 1);
+    const __m256i ones   = _mm256_set1_epi32(-1);
+    const __m256i step_x = _mm256_set1_epi32(pa * 8);
+    const __m256i step_y = _mm256_set1_epi32(pc * 8);
+    const __m128i pitch  = _mm_cvtsi32_si128(__builtin_ctz(size >> 3)); // log2 of the map width in tiles
+
+    __m256i vx = _mm256_add_epi32(_mm256_set1_epi32(x), _mm256_mullo_epi32(lane, _mm256_set1_epi32(pa)));
+    __m256i vy = _mm256_add_epi32(_mm256_set1_epi32(y), _mm256_mullo_epi32(lane, _mm256_set1_epi32(pc)));
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i tx = _mm256_srai_epi32(vx, 8);
+        __m256i ty = _mm256_srai_epi32(vy, 8);
+        __m256i inside = ones;
+
+        if (wrap)
+        {
+            tx = _mm256_and_si256(tx, mask);
+            ty = _mm256_and_si256(ty, mask);
+        }
+
+        // 0 <= t < size, and outside lanes look up texel (0, 0) so the gathers stay in VRAM
+        else
+        {
+            inside = _mm256_and_si256(_mm256_and_si256(_mm256_cmpgt_epi32(tx, ones), _mm256_cmpgt_epi32(limit, tx)),
+                                      _mm256_and_si256(_mm256_cmpgt_epi32(ty, ones), _mm256_cmpgt_epi32(limit, ty)));
+            tx = _mm256_and_si256(tx, inside);
+            ty = _mm256_and_si256(ty, inside);
+        }
+
+        __m256i entry = _mm256_add_epi32(_mm256_sll_epi32(_mm256_srli_epi32(ty, 3), pitch), _mm256_srli_epi32(tx, 3));
+        __m256i tile  = _mm256_and_si256(_mm256_i32gather_epi32((const int *) map, entry, 1), bytes);
+
+        __m256i texel = _mm256_add_epi32(_mm256_slli_epi32(tile, 6),
+                        _mm256_add_epi32(_mm256_slli_epi32(_mm256_and_si256(ty, seven), 3), _mm256_and_si256(tx, seven)));
+        __m256i index = _mm256_and_si256(_mm256_i32gather_epi32((const int *) tiles, texel, 1), _mm256_and_si256(bytes, inside));
+
+        // 8 x 32 bit down to 8 x 8 bit
+        __m128i words = _mm_packus_epi32(_mm256_castsi256_si128(index), _mm256_extracti128_si256(index, 1));
+        _mm_storel_epi64((__m128i *) (dst + i), _mm_packus_epi16(words, words));
+
+        vx = _mm256_add_epi32(vx, step_x);
+        vy = _mm256_add_epi32(vy, step_y);
+    }
+
+    AffineLineScalar(map, tiles, size, wrap, x + pa * i, y + pc * i, pa, pc, dst + i, count - i);
+}
+
+__attribute__((target("avx2")))
+static void ColorLutAVX2(const u32 *src, const u32 *lut, u32 *dst, int count)
+{
+    const __m256i mask_r = _mm256_set1_epi32(0x7C00);
+    const __m256i mask_g = _mm256_set1_epi32(0x03E0);
+    const __m256i mask_b = _mm256_set1_epi32(0x001F);
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i c = _mm256_loadu_si256((const __m256i *) (src + i));
+
+        __m256i index = _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(c, 9), mask_r),
+                        _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(c, 6), mask_g),
+                                        _mm256_and_si256(_mm256_srli_epi32(c, 3), mask_b)));
+
+        _mm256_storeu_si256((__m256i *) (dst + i), _mm256_i32gather_epi32((const int *) lut, index, 4));
+    }
+
+    ColorLutScalar(src + i, lut, dst + i, count - i);
+}
+
+// pavgb rounds up, so take 1 off the odd sums of the bytes where a is below b
+__attribute__((target("sse2")))
+static void AverageSSE2(const u32 *a, const u32 *b, u32 *dst, int count)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i ones = _mm_set1_epi8(1);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i va = _mm_loadu_si128((const __m128i *) (a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i *) (b + i));
+
+        __m128i odd   = _mm_and_si128(_mm_xor_si128(va, vb), ones);
+        __m128i below = _mm_andnot_si128(_mm_cmpeq_epi8(_mm_subs_epu8(vb, va), zero), odd);
+
+        _mm_storeu_si128((__m128i *) (dst + i), _mm_sub_epi8(_mm_avg_epu8(va, vb), below));
+    }
+
+    AverageScalar(a + i, b + i, dst + i, count - i);
+}
+
+__attribute__((target("avx2")))
+static void AverageAVX2(const u32 *a, const u32 *b, u32 *dst, int count)
+{
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i ones = _mm256_set1_epi8(1);
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i va = _mm256_loadu_si256((const __m256i *) (a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i *) (b + i));
+
+        __m256i odd   = _mm256_and_si256(_mm256_xor_si256(va, vb), ones);
+        __m256i below = _mm256_andnot_si256(_mm256_cmpeq_epi8(_mm256_subs_epu8(vb, va), zero), odd);
+
+        _mm256_storeu_si256((__m256i *) (dst + i), _mm256_sub_epi8(_mm256_avg_epu8(va, vb), below));
+    }
+
+    AverageScalar(a + i, b + i, dst + i, count - i);
+}
+
+// 4 pixels per iteration, r and g paired in 16 bit lanes so pmaddwd does two of the three products at once
+// the sums are exact 32 bit, so the results match the scalar version bit for bit
+__attribute__((target("sse2")))
+static void RgbToYuvSSE2(const u32 *src, u32 *dst, int count)
+{
+    const __m128i byte = _mm_set1_epi32(0xFF);
+    const __m128i bias = _mm_set1_epi32(128);
+
+    // lane pairs (r, g) and (b, 0)
+    const __m128i y_rg = _mm_set1_epi32(150 << 16 | 77);
+    const __m128i y_b  = _mm_set1_epi32(29);
+    const __m128i u_rg = _mm_set1_epi32((u32) -85 << 16 | (u16) -43);
+    const __m128i u_b  = _mm_set1_epi32(128);
+    const __m128i v_rg = _mm_set1_epi32((u32) -107 << 16 | 128);
+    const __m128i v_b  = _mm_set1_epi32((u16) -21);
+
+    int i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i c  = _mm_loadu_si128((const __m128i *) (src + i));
+        __m128i rg = _mm_or_si128(_mm_and_si128(_mm_srli_epi32(c, 16), byte), _mm_slli_epi32(_mm_and_si128(_mm_srli_epi32(c, 8), byte), 16));
+        __m128i b  = _mm_and_si128(c, byte);
+
+        __m128i y = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(rg, y_rg), _mm_madd_epi16(b, y_b)), 8);
+        __m128i u = _mm_add_epi32(_mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(rg, u_rg), _mm_madd_epi16(b, u_b)), 8), bias);
+        __m128i v = _mm_add_epi32(_mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(rg, v_rg), _mm_madd_epi16(b, v_b)), 8), bias);
+
+        _mm_storeu_si128((__m128i *) (dst + i), _mm_or_si128(_mm_slli_epi32(y, 16), _mm_or_si128(_mm_slli_epi32(u, 8), v)));
+    }
+
+    RgbToYuvScalar(src + i, dst + i, count - i);
+}
+
+__attribute__((target("avx2")))
+static void RgbToYuvAVX2(const u32 *src, u32 *dst, int count)
+{
+    const __m256i byte = _mm256_set1_epi32(0xFF);
+    const __m256i bias = _mm256_set1_epi32(128);
+
+    const __m256i y_rg = _mm256_set1_epi32(150 << 16 | 77);
+    const __m256i y_b  = _mm256_set1_epi32(29);
+    const __m256i u_rg = _mm256_set1_epi32((u32) -85 << 16 | (u16) -43);
+    const __m256i u_b  = _mm256_set1_epi32(128);
+    const __m256i v_rg = _mm256_set1_epi32((u32) -107 << 16 | 128);
+    const __m256i v_b  = _mm256_set1_epi32((u16) -21);
+
+    int i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256i c  = _mm256_loadu_si256((const __m256i *) (src + i));
+        __m256i rg = _mm256_or_si256(_mm256_and_si256(_mm256_srli_epi32(c, 16), byte), _mm256_slli_epi32(_mm256_and_si256(_mm256_srli_epi32(c, 8), byte), 16));
+        __m256i b  = _mm256_and_si256(c, byte);
+
+        __m256i y = _mm256_srai_epi32(_mm256_add_epi32(_mm256_madd_epi16(rg, y_rg), _mm256_madd_epi16(b, y_b)), 8);
+        __m256i u = _mm256_add_epi32(_mm256_srai_epi32(_mm256_add_epi32(_mm256_madd_epi16(rg, u_rg), _mm256_madd_epi16(b, u_b)), 8), bias);
+        __m256i v = _mm256_add_epi32(_mm256_srai_epi32(_mm256_add_epi32(_mm256_madd_epi16(rg, v_rg), _mm256_madd_epi16(b, v_b)), 8), bias);
+
+        _mm256_storeu_si256((__m256i *) (dst + i), _mm256_or_si256(_mm256_slli_epi32(y, 16), _mm256_or_si256(_mm256_slli_epi32(u, 8), v)));
+    }
+
+    RgbToYuvScalar(src + i, dst + i, count - i);
+}
+
+// 2x and 4x are shuffles of 4 pixels, anything else goes pixel by pixel
+__attribute__((target("sse2")))
+static void RepeatPixelsSSE2(const u32 *src, u32 *dst, int count, int n)
+{
+    int i = 0;
+
+    if (n == 2)
+    {
+        for (; i + 4 <= count; i += 4, dst += 8)
+        {
+            __m128i c = _mm_loadu_si128((const __m128i *) (src + i));
+            _mm_storeu_si128((__m128i *) dst,       _mm_unpacklo_epi32(c, c));
+            _mm_storeu_si128((__m128i *) (dst + 4), _mm_unpackhi_epi32(c, c));
+        }
+    }
+
+    else if (n == 4)
+    {
+        for (; i + 4 <= count; i += 4, dst += 16)
+        {
+            __m128i c = _mm_loadu_si128((const __m128i *) (src + i));
+            _mm_storeu_si128((__m128i *) dst,        _mm_shuffle_epi32(c, 0x00));
+            _mm_storeu_si128((__m128i *) (dst + 4),  _mm_shuffle_epi32(c, 0x55));
+            _mm_storeu_si128((__m128i *) (dst + 8),  _mm_shuffle_epi32(c, 0xAA));
+            _mm_storeu_si128((__m128i *) (dst + 12), _mm_shuffle_epi32(c, 0xFF));
+        }
+    }
+
+    RepeatPixelsScalar(src + i, dst, count - i, n);
+}
+
+// 4 pixels per iteration, the edge pixels (whose neighbors are clamped) are done by Scale2xRange
+__attribute__((target("sse2")))
+static void Scale2xLineSSE2(const u32 *above, const u32 *line, const u32 *below, u32 *out0, u32 *out1, int width)
+{
+    Scale2xRange(above, line, below, out0, out1, width, 0, 1);
+
+    int x = 1;
+    for (; x + 4 < width; x += 4)
+    {
+        __m128i b = _mm_loadu_si128((const __m128i *) (above + x));
+        __m128i e = _mm_loadu_si128((const __m128i *) (line  + x));
+        __m128i h = _mm_loadu_si128((const __m128i *) (below + x));
+        __m128i d = _mm_loadu_si128((const __m128i *) (line  + x - 1));
+        __m128i f = _mm_loadu_si128((const __m128i *) (line  + x + 1));
+
+        // b != h && d != f
+        __m128i edge = _mm_andnot_si128(_mm_or_si128(_mm_cmpeq_epi32(b, h), _mm_cmpeq_epi32(d, f)), _mm_set1_epi32(-1));
+
+        // pick (edge && p == q) ? p : e
+        auto pick = [&](__m128i p, __m128i q)
+        {
+            __m128i take = _mm_and_si128(edge, _mm_cmpeq_epi32(p, q));
+            return _mm_or_si128(_mm_and_si128(take, p), _mm_andnot_si128(take, e));
+        };
+
+        __m128i e0 = pick(d, b), e1 = pick(f, b);
+        __m128i e2 = pick(d, h), e3 = pick(f, h);
+
+        _mm_storeu_si128((__m128i *) (out0 + x * 2),     _mm_unpacklo_epi32(e0, e1));
+        _mm_storeu_si128((__m128i *) (out0 + x * 2 + 4), _mm_unpackhi_epi32(e0, e1));
+        _mm_storeu_si128((__m128i *) (out1 + x * 2),     _mm_unpacklo_epi32(e2, e3));
+        _mm_storeu_si128((__m128i *) (out1 + x * 2 + 4), _mm_unpackhi_epi32(e2, e3));
+    }
+
+    Scale2xRange(above, line, below, out0, out1, width, x, width);
+}
+
+#endif
+
+void (*Simd::ConvertBGR555)(const u8 *, u32 *, int)              = ConvertBGR555Scalar;
+void (*Simd::GatherPalette)(const u8 *, const u32 *, u32 *, int) = GatherPaletteScalar;
+void (*Simd::AffineLine)(const u8 *, const u8 *, int, bool, s32, s32, s32, s32, u8 *, int) = AffineLineScalar;
+void (*Simd::ColorLut)(const u32 *, const u32 *, u32 *, int)    = ColorLutScalar;
+void (*Simd::Average)(const u32 *, const u32 *, u32 *, int)     = AverageScalar;
+void (*Simd::RgbToYuv)(const u32 *, u32 *, int)                 = RgbToYuvScalar;
+void (*Simd::RepeatPixels)(const u32 *, u32 *, int, int)        = RepeatPixelsScalar;
+void (*Simd::Scale2xLine)(const u32 *, const u32 *, const u32 *, u32 *, u32 *, int) = Scale2xLineScalar;
+const char *Simd::isa = "scalar";
+
+bool Simd::Use(const std::string &name)
+{
+    bool avx2 = false;
+    bool sse2 = false;
+
+    #ifdef SIMD_X86
+    __builtin_cpu_init();
+
+    avx2 = name == "avx2" && __builtin_cpu_supports("avx2");
+    sse2 = name == "sse2" && __builtin_cpu_supports("sse2");
+    #endif
+
+    if (!avx2 && !sse2 && name != "scalar")
+        return false;
+
+    // the wider sets only replace the kernels they have
+    ConvertBGR555 = ConvertBGR555Scalar;
+    GatherPalette = GatherPaletteScalar;
+    AffineLine    = AffineLineScalar;
+    ColorLut      = ColorLutScalar;
+    Average       = AverageScalar;
+    RgbToYuv      = RgbToYuvScalar;
+    RepeatPixels  = RepeatPixelsScalar;
+    Scale2xLine   = Scale2xLineScalar;
+    isa = "scalar";
+
+    #ifdef SIMD_X86
+    if (avx2)
+    {
+        ConvertBGR555 = ConvertBGR555AVX2;
+        GatherPalette = GatherPaletteAVX2;
+        AffineLine    = AffineLineAVX2;
+        ColorLut      = ColorLutAVX2;
+        Average       = AverageAVX2;
+        RgbToYuv      = RgbToYuvAVX2;
+        RepeatPixels  = RepeatPixelsSSE2; // sse2 is part of avx2, and wider shuffles cross lanes
+        Scale2xLine   = Scale2xLineSSE2;
+        isa = "avx2";
+    }
+
+    if (sse2)
+    {
+        ConvertBGR555 = ConvertBGR555SSE2;
+        GatherPalette = GatherPaletteSSE2;
+        Average       = AverageSSE2;
+        RgbToYuv      = RgbToYuvSSE2;
+        RepeatPixels  = RepeatPixelsSSE2;
+        Scale2xLine   = Scale2xLineSSE2;
+        isa = "sse2"; // AffineLine and ColorLut stay scalar, sse2 has no gather
+    }
+    #endif
+
+    return true;
+}
+
+// pick the widest kernels the host supports before main runs
+static bool kernels_selected = Simd::Use("avx2") || Simd::Use("sse2");
@@ -0,0 +1,146 @@
+/* discovery
+ * License: GPLv2
+ * See LICENSE.txt for full license text
+ *
+ * FILE: ThreadPool.cpp
+ * DATE: October 19th, 2026
+ * DESCRIPTION: fork-join pool that spreads numbered tasks over worker threads with work stealing
+ */
+
+#include <algorithm>
+
+#include "ThreadPool.h"
+
+ThreadPool::ThreadPool(int threads) : runs(std::max(threads, 1)), job(0), stopping(false), task(NULL), remaining(0)
+{
+    for (int thread = 1; thread < Threads(); ++thread)
+        workers.emplace_back(&ThreadPool::Work, this, thread);
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+
+    wake.notify_all();
+
+    for (auto &worker : workers)
+        worker.join();
+}
+
+void ThreadPool::Run(int count, const std::function<void(int, int)> &task)
+{
+    int threads = Threads();
+
+    // set before any task can be claimed, so a late worker's finished task is never lost
+    this->task = &task;
+    remaining.store(count);
+
+    // thread t starts with tasks [count * t / threads, count * (t + 1) / threads)
+    for (int t = 0; t < threads; ++t)
+    {
+        u64 begin = (u64) count * t / threads;
+        u64 end   = (u64) count * (t + 1) / threads;
+
+        runs[t].range.store(end << 32 | begin);
+    }
+
+    if (threads > 1)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            ++job;
+        }
+
+        wake.notify_all();
+    }
+
+    Drain(0);
+
+    // the last tasks are finishing on other threads
+    while (remaining.load() > 0)
+        std::this_thread::yield();
+}
+
+void ThreadPool::Work(int thread)
+{
+    u64 seen = 0;
+
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || job != seen; });
+
+            if (stopping)
+                return;
+
+            seen = job;
+        }
+
+        Drain(thread);
+    }
+}
+
+// run tasks from this thread's own range, then from everyone else's, until none are left
+void ThreadPool::Drain(int thread)
+{
+    int threads = Threads();
+    int index;
+
+    for (;;)
+    {
+        bool found = Take(thread, index);
+
+        for (int i = 1; i < threads && !found; ++i)
+            found = Steal((thread + i) % threads, index);
+
+        if (!found)
+            return;
+
+        (*task)(index, thread);
+        remaining.fetch_sub(1);
+    }
+}
+
+// claim the first task of a thread's own range
+bool ThreadPool::Take(int thread, int &index)
+{
+    u64 range = runs[thread].range.load();
+
+    for (;;)
+    {
+        u32 begin = range, end = range >> 32;
+
+        if (begin >= end)
+            return false;
+
+        if (runs[thread].range.compare_exchange_weak(range, (u64) end << 32 | (begin + 1)))
+        {
+            index = begin;
+            return true;
+        }
+    }
+}
+
+// claim the last task of another thread's range
+bool ThreadPool::Steal(int victim, int &index)
+{
+    u64 range = runs[victim].range.load();
+
+    for (;;)
+    {
+        u32 begin = range, end = range >> 32;
+
+        if (begin >= end)
+            return false;
+
+        if (runs[victim].range.compare_exchange_weak(range, (u64) (end - 1) << 32 | begin))
+        {
+            index = end - 1;
+            return true;
+        }
+    }
+}
@@ -160,6 +160,24 @@ ThumbInstruction Util::GetInstructionFormat(u16 instruction)
         return ThumbInstruction::UND;
 }
 
+u8 Util::arm_decode_table[0x1000];
+u8 Util::thumb_decode_table[0x100];
+
+// fill the decode tables from the reference decoder before main runs
+static bool BuildDecodeTables()
+{
+    // bits 19-8 and 3-0 are left clear, which never decode as BEX (see DecodeArm)
+    for (u32 i = 0; i < 0x1000; ++i)
+        Util::arm_decode_table[i] = (u8) Util::GetInstructionFormat((u32) ((i & 0xFF0) << 16 | (i & 0xF) << 4));
+
+    for (u32 i = 0; i < 0x100; ++i)
+        Util::thumb_decode_table[i] = (u8) Util::GetInstructionFormat((u16) (i << 8));
+
+    return true;
+}
+
+static bool decode_tables_built = BuildDecodeTables();
+
 bool Util::PathExists(std::string path)
 {
 	std::fstream fin(path);
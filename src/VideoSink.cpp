@@ -0,0 +1,221 @@
+/* discovery
+ * License: GPLv2
+ * See LICENSE.txt for full license text
+ *
+ * FILE: VideoSink.cpp
+ * DATE: October 19th, 2026
+ * DESCRIPTION: where the ppu's finished frames go - an SDL window, nowhere, a file or memory
+ */
+
+#include <cstring>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+#include "VideoSink.h"
+
+// the texture format each PixelFormat is drawn into
+static Uint32 TextureFormat(PixelFormat format)
+{
+    switch (format)
+    {
+        case PixelFormat::RGB565:   return SDL_PIXELFORMAT_RGB565;
+        case PixelFormat::BGRA8888: return SDL_PIXELFORMAT_BGRA32;
+        case PixelFormat::BGR555:   return SDL_PIXELFORMAT_BGR555;
+        default:                    return SDL_PIXELFORMAT_RGB888; // SDL's xRGB8888
+    }
+}
+
+SdlSink::SdlSink(const PostConfig &config, PixelFormat format) : VideoSink(format)
+{
+    if (config.Enabled())
+        post = std::make_unique<PostProcess>(config);
+
+    int width  = post ? post->Width()  : SCREEN_WIDTH;
+    int height = post ? post->Height() : SCREEN_HEIGHT;
+
+    if (SDL_Init(SDL_INIT_VIDEO) < 0)
+    {
+        LOG(LogLevel::Error, "Could not initialize PPU");
+        exit(2);
+    }
+
+    window = SDL_CreateWindow("discovery", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED, std::max(width, SCREEN_WIDTH * 2), std::max(height, SCREEN_HEIGHT * 2), SDL_WINDOW_RESIZABLE);
+
+    if (window == NULL)
+    {
+        LOG(LogLevel::Error, "Could not create window");
+        exit(2);
+    }
+
+    // discovery icon logo
+    SDL_Surface *logo = SDL_LoadBMP("assets/discovery.bmp");
+
+    if (logo == NULL)
+    {
+        LOG(LogLevel::Error, "Could not load discovery logo!\n");
+        exit(2);
+    }
+
+    SDL_SetWindowIcon(window, logo);
+    SDL_FreeSurface(logo);
+
+    // scale on the gpu if there is one, falling back to SDL's software renderer
+    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+
+    if (renderer == NULL)
+        renderer = SDL_CreateRenderer(window, -1, 0);
+
+    if (renderer == NULL)
+    {
+        LOG(LogLevel::Error, "Could not create renderer: {}\n", SDL_GetError());
+        exit(2);
+    }
+
+    // sharp pixels, and the picture letterboxed at the gba's aspect ratio however the window is sized
+    SDL_SetHint(SDL_HINT_RENDER_SCALE_QUALITY, "nearest");
+    SDL_RenderSetLogicalSize(renderer, width, height);
+
+    // frames are drawn in the texture's own format, SDL_Renderer converts on the gpu if it must
+    texture = SDL_CreateTexture(renderer, TextureFormat(format), SDL_TEXTUREACCESS_STREAMING, width, height);
+
+    if (texture == NULL)
+    {
+        LOG(LogLevel::Error, "Could not create texture: {}\n", SDL_GetError());
+        exit(2);
+    }
+
+    repaint = true;
+}
+
+SdlSink::~SdlSink()
+{
+    SDL_DestroyTexture(texture);
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+}
+
+void SdlSink::Present(const void *pixels, const FrameDamage &damage)
+{
+    // ghosting keeps fading towards a still frame, so it changes the picture even when the frame doesn't
+    bool temporal = post && post->Temporal();
+
+    // the texture and the window already show this frame
+    if (!damage.Any() && !repaint && !temporal)
+        return;
+
+    if (post)
+    {
+        void *texels;
+        int bytes;
+
+        if (SDL_LockTexture(texture, NULL, &texels, &bytes) != 0)
+            return;
+
+        post->Run((const u32 *) pixels, (u32 *) texels, bytes / sizeof(u32));
+        SDL_UnlockTexture(texture);
+    }
+
+    // upload each run of dirty lines, the rest of the texture still holds them
+    else
+    {
+        damage.ForEachRun([&](int first, int last)
+        {
+            SDL_Rect rect = { 0, first, SCREEN_WIDTH, last - first };
+            SDL_UpdateTexture(texture, &rect, (const u8 *) pixels + first * LineBytes(), LineBytes());
+        });
+    }
+
+    repaint = false;
+
+    SDL_RenderClear(renderer);
+    SDL_RenderCopy(renderer, texture, NULL, NULL);
+    SDL_RenderPresent(renderer);
+}
+
+bool SdlSink::PollEvent(SDL_Event &e)
+{
+    if (!SDL_PollEvent(&e))
+        return false;
+
+    // the window's contents are gone or stretched, even a frame with no damage has to be presented again
+    if (e.type == SDL_WINDOWEVENT)
+        repaint = true;
+
+    return true;
+}
+
+void SdlSink::ShowStats(double fps, u32 lag_frames)
+{
+    std::stringstream stream;
+    stream << std::fixed << std::setprecision(1) << fps;
+    std::string title("");
+    title += "discovery - ";
+    title += stream.str();
+    title += " fps - ";
+    title += std::to_string(lag_frames);
+    title += " lag frames";
+    SDL_SetWindowTitle(window, title.c_str());
+}
+
+FileSink::FileSink(const std::string &path, PixelFormat format) : VideoSink(format)
+{
+    file = std::fopen(path.c_str(), "wb");
+
+    if (file == NULL)
+    {
+        LOG(LogLevel::Error, "Error: Unable to open {} for video output\n", path);
+        exit(1);
+    }
+}
+
+FileSink::~FileSink()
+{
+    std::fclose(file);
+}
+
+void FileSink::Present(const void *pixels, const FrameDamage &)
+{
+    std::fwrite(pixels, LineBytes(), SCREEN_HEIGHT, file);
+}
+
+void MemorySink::Present(const void *pixels, const FrameDamage &damage)
+{
+    damage.ForEachRun([&](int first, int last)
+    {
+        for (int line = first; line < last; ++line)
+            std::memcpy(buffer + line * pitch, (const u8 *) pixels + line * LineBytes(), LineBytes());
+    });
+
+    ++frames;
+}
+
+VideoSink *MakeVideoSink(const std::string &name, const PostConfig &post, PixelFormat format)
+{
+    if (name == "sdl")
+    {
+        if (post.Enabled() && format != PixelFormat::XRGB8888)
+        {
+            LOG(LogLevel::Warning, "Post-processing works on xrgb8888 frames, drawing the window in xrgb8888\n");
+            format = PixelFormat::XRGB8888;
+        }
+
+        return new SdlSink(post, format);
+    }
+
+    if (post.Enabled())
+        LOG(LogLevel::Warning, "Post-processing only applies to the sdl window, ignoring it\n");
+
+    if (name == "null")
+        return new NullSink(format);
+
+    if (name == "memory")
+        return new MemorySink(format);
+
+    if (name.rfind("file:", 0) == 0 && name.size() > 5)
+        return new FileSink(name.substr(5), format);
+
+    LOG(LogLevel::Error, "Error: Unknown video output {} (sdl, null, memory or file:<path>)\n", name);
+    exit(1);
+}
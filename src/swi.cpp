@@ -16,7 +16,8 @@
  * 
  * 
  */
-void Arm7Tdmi::SwiSoftReset()
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::SwiSoftReset()
 {
     
 }
@@ -37,7 +38,8 @@ void Arm7Tdmi::SwiSoftReset()
  * The function always switches the screen into forced blank by setting DISPCNT=0080h
  * (regardless of incoming R0, screen becomes white).
  */
-void Arm7Tdmi::SwiRegisterRamReset()
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::SwiRegisterRamReset()
 {
     u8 flags = GetRegister(r0) & 0xFF;
 
@@ -103,7 +105,8 @@ void Arm7Tdmi::SwiRegisterRamReset()
  * 
  * Halts execution until a VBlank interrupt arises
  */
-void Arm7Tdmi::SwiVBlankIntrWait()
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::SwiVBlankIntrWait()
 {
     // force interrupts to be enabled
     // mem->Write32Unsafe(REG_IME, 0x1);
@@ -134,7 +137,8 @@ void Arm7Tdmi::SwiVBlankIntrWait()
  * r1 - number MOD denom, signed
  * r3 - abs(number DIV) denom, unsigned
  */
-void Arm7Tdmi::SwiDivision()
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::SwiDivision()
 {
     s32 num   = (s32) GetRegister(r0);
     s32 denom = (s32) GetRegister(r1);
@@ -158,7 +162,8 @@ void Arm7Tdmi::SwiDivision()
  * return:
  * r0 - u16 result
  */
-void Arm7Tdmi::SwiSqrt()
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::SwiSqrt()
 {
     u32 num    = GetRegister(r0);
     u16 result = (u16) sqrt(num);
@@ -174,7 +179,8 @@ void Arm7Tdmi::SwiSqrt()
  * return:
  * r0 - 0x0000 - 0xFFFF for 0 <= theta <= 2π
  */
-void Arm7Tdmi::SwiArctan2()
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::SwiArctan2()
 {
     s16 x = GetRegister(r0);
     s16 y = GetRegister(r1);
@@ -189,7 +195,8 @@ void Arm7Tdmi::SwiArctan2()
     SetRegister(r0, (u16) result);
 }
 
-void Arm7Tdmi::SwiCpuSet()
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::SwiCpuSet()
 {
     u32 src_ptr  = GetRegister(r0);
     u32 dest_ptr = GetRegister(r1);
@@ -285,7 +292,8 @@ void Arm7Tdmi::SwiCpuSet()
 /*
  * ObjAffineSet
  */
-void Arm7Tdmi::SwiObjAffineSet()
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::SwiObjAffineSet()
 {
     //return;
     u32 src_ptr          = GetRegister(r0);
@@ -338,7 +346,8 @@ void Arm7Tdmi::SwiObjAffineSet()
  *      8bit   Width of Destination Units in bits (only 1,2,4,8,16,32 supported)
  *      32bit  Data Offset (Bit 0-30), and Zero Data Flag (Bit 31)
  */
-void Arm7Tdmi::SwiBitUnpack()
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::SwiBitUnpack()
 {
     u32 src_ptr     = GetRegister(r0);
     u32 dest_ptr    = GetRegister(r1) & ~0x3;
@@ -425,7 +434,8 @@ void Arm7Tdmi::SwiBitUnpack()
     // std::cout << "dest_width: " << (int) dest_width << "\n";
 }
 
-void Arm7Tdmi::SwiRLUnCompVRAM()
+template <typename Accuracy>
+void Arm7Tdmi<Accuracy>::SwiRLUnCompVRAM()
 {
     u32 src_ptr, dest_ptr;
     src_ptr  = GetRegister(r0) & ~0x3; // word aligned
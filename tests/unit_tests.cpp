@@ -0,0 +1,443 @@
+/* discovery
+ * License: GPLv2
+ * See LICENSE.txt for full license text
+ *
+ * FILE: unit_tests.cpp
+ * DATE: October 19th, 2026
+ * DESCRIPTION: standalone checks of the simd kernels and the threading primitives, make unit_tests
+ */
+
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Simd.h"
+#include "ThreadPool.h"
+#include "TripleBuffer.h"
+#include "SpscQueue.h"
+#include "ShmExport.h"
+
+static int failures = 0;
+
+#define CHECK(condition, ...)                                       \
+    do                                                              \
+    {                                                               \
+        if (!(condition))                                           \
+        {                                                           \
+            std::printf("FAIL %s:%d: ", __FILE__, __LINE__);        \
+            std::printf(__VA_ARGS__);                               \
+            std::printf("\n");                                      \
+            ++failures;                                             \
+            return;                                                 \
+        }                                                           \
+    } while (0)
+
+static std::mt19937 rng(0xD15C0);
+
+static void Fill(void *buffer, size_t bytes)
+{
+    for (size_t i = 0; i < bytes; ++i)
+        ((u8 *) buffer)[i] = rng();
+}
+
+// mostly a handful of colors, so equality tests like Scale2x's take both branches
+static void FillColors(u32 *buffer, int count)
+{
+    static const u32 colors[] = { 0x000000, 0xFFFFFF, 0x123456, 0x00FF00 };
+
+    for (int i = 0; i < count; ++i)
+        buffer[i] = rng() % 8 < 6 ? colors[rng() % 4] : rng() & 0xFFFFFF;
+}
+
+/*
+ * Every kernel in the set named isa against the scalar one, on random input and counts
+ * that leave every tail length.
+ */
+static void TestSimd(const std::string &isa)
+{
+    if (!Simd::Use(isa))
+    {
+        std::printf("skip simd %s, not supported here\n", isa.c_str());
+        return;
+    }
+
+    constexpr int MAX = 1024;
+
+    std::vector<u8>  bytes(MAX * 2), map(128 * 128), tiles(256 * 64), indices(MAX);
+    std::vector<u32> a(MAX), b(MAX), c(MAX), palette(256), lut(32 * 32 * 32);
+    std::vector<u32> expected(MAX * 4), actual(MAX * 4), expected2(MAX * 2), actual2(MAX * 2);
+    std::vector<u8>  expected8(MAX), actual8(MAX);
+
+    for (int round = 0; round < 200; ++round)
+    {
+        int count = rng() % MAX;
+
+        Fill(bytes.data(), bytes.size());
+        Fill(map.data(), map.size());
+        Fill(tiles.data(), tiles.size());
+        Fill(indices.data(), indices.size());
+        Fill(palette.data(), palette.size() * 4);
+        Fill(lut.data(), lut.size() * 4);
+        Fill(a.data(), a.size() * 4);
+
+        // b near a half of the time, so Average sees sums that differ by 1
+        for (int i = 0; i < MAX; ++i)
+            b[i] = rng() % 2 ? a[i] ^ (rng() & 0x01010101) : rng();
+
+        FillColors(c.data(), MAX);
+
+        auto compare = [&](const char *kernel, const void *x, const void *y, size_t size)
+        {
+            CHECK(std::memcmp(x, y, size) == 0, "%s %s differs from scalar, count %d", isa.c_str(), kernel, count);
+        };
+
+        // call writes into actual, the scalar result ends up in expected
+        #define BOTH(call, out)                    \
+            Simd::Use("scalar");                   \
+            call;                                  \
+            std::swap(expected##out, actual##out); \
+            Simd::Use(isa);                        \
+            call;
+
+        BOTH(Simd::ConvertBGR555(bytes.data(), actual.data(), count), );
+        compare("ConvertBGR555", expected.data(), actual.data(), count * 4);
+
+        BOTH(Simd::GatherPalette(indices.data(), palette.data(), actual.data(), count), );
+        compare("GatherPalette", expected.data(), actual.data(), count * 4);
+
+        bool wrap = rng() % 2;
+        s32 x  = (s32) (rng() % 0x20000) - 0x8000;
+        s32 y  = (s32) (rng() % 0x20000) - 0x8000;
+        s32 pa = (s16) rng();
+        s32 pc = (s16) rng();
+
+        int size = 128 << (rng() % 4);
+
+        BOTH(Simd::AffineLine(map.data(), tiles.data(), size, wrap, x, y, pa, pc, actual8.data(), count), 8);
+        compare("AffineLine", expected8.data(), actual8.data(), count);
+
+        BOTH(Simd::ColorLut(a.data(), lut.data(), actual.data(), count), );
+        compare("ColorLut", expected.data(), actual.data(), count * 4);
+
+        BOTH(Simd::Average(a.data(), b.data(), actual.data(), count), );
+        compare("Average", expected.data(), actual.data(), count * 4);
+
+        BOTH(Simd::RgbToYuv(a.data(), actual.data(), count), );
+        compare("RgbToYuv", expected.data(), actual.data(), count * 4);
+
+        int n = rng() % 4 + 1;
+        BOTH(Simd::RepeatPixels(a.data(), actual.data(), count, n), );
+        compare("RepeatPixels", expected.data(), actual.data(), count * n * 4);
+
+        // the rows overlap, the kernel reads three lines of width pixels from anywhere
+        int width = count / 3;
+
+        Simd::Use("scalar");
+        Simd::Scale2xLine(&c[0], &c[width], &c[width * 2], expected.data(), expected2.data(), width);
+        Simd::Use(isa);
+        Simd::Scale2xLine(&c[0], &c[width], &c[width * 2], actual.data(), actual2.data(), width);
+
+        compare("Scale2xLine", expected.data(), actual.data(), width * 2 * 4);
+        compare("Scale2xLine", expected2.data(), actual2.data(), width * 2 * 4);
+
+        #undef BOTH
+
+        if (failures != 0)
+            break;
+    }
+
+    std::printf("simd %s\n", isa.c_str());
+}
+
+/*
+ * Every task of every Run runs exactly once, on a thread the pool has, with uneven task
+ * costs so threads run dry and steal.
+ */
+static void TestThreadPool()
+{
+    for (int threads : { 1, 2, 4, 7 })
+    {
+        ThreadPool pool(threads);
+        std::vector<std::atomic<int>> runs(512);
+
+        for (int round = 0; round < 500; ++round)
+        {
+            int count = rng() % runs.size();
+            std::atomic<bool> bad_thread{false};
+
+            for (auto &r : runs)
+                r = 0;
+
+            pool.Run(count, [&](int index, int thread)
+            {
+                if (thread < 0 || thread >= pool.Threads())
+                    bad_thread = true;
+
+                // a few slow tasks at the front, where thread 0's run is
+                if (index < 4)
+                    std::this_thread::sleep_for(std::chrono::microseconds(50));
+
+                runs[index].fetch_add(1, std::memory_order_relaxed);
+            });
+
+            CHECK(!bad_thread, "ThreadPool(%d) passed a thread index out of range", threads);
+
+            for (int i = 0; i < (int) runs.size(); ++i)
+                CHECK(runs[i] == (i < count), "ThreadPool(%d) ran task %d of %d %d times", threads, i, count, (int) runs[i]);
+        }
+    }
+
+    std::printf("ThreadPool\n");
+}
+
+// frame n is n in every pixel and hash, so a torn or mixed up frame shows
+static void DrawTestFrame(TripleBuffer &frames, u64 n)
+{
+    u32 *pixels = (u32 *) frames.Back();
+
+    for (int i = 0; i < SCREEN_WIDTH * SCREEN_HEIGHT; ++i)
+        pixels[i] = (u32) n;
+
+    for (int line = 0; line < SCREEN_HEIGHT; ++line)
+        frames.BackHashes()[line] = n;
+}
+
+static bool WholeFrame(const Frame &frame)
+{
+    const u32 *pixels = (const u32 *) frame.pixels;
+
+    for (int i = 0; i < SCREEN_WIDTH * SCREEN_HEIGHT; ++i)
+        if (pixels[i] != (u32) frame.number)
+            return false;
+
+    for (int line = 0; line < SCREEN_HEIGHT; ++line)
+        if (frame.hashes[line] != frame.number)
+            return false;
+
+    return frame.keys == (u16) frame.number;
+}
+
+/*
+ * A producer thread publishes frames while this one acquires them: frames come out whole
+ * and in order, and with WaitTaken (what lossless sinks use) none is skipped.
+ */
+static void TestTripleBuffer(bool lossless)
+{
+    constexpr u64 FRAMES = 2000;
+
+    auto frames = std::make_unique<TripleBuffer>();
+
+    std::thread producer([&]
+    {
+        for (u64 n = 1; n <= FRAMES; ++n)
+        {
+            DrawTestFrame(*frames, n);
+
+            if (lossless)
+                frames->WaitTaken();
+
+            frames->Publish(n, (u16) n);
+        }
+    });
+
+    u64 last = 0;
+    u64 taken = 0;
+    bool whole = true;
+    bool ordered = true;
+
+    while (last != FRAMES)
+    {
+        if (!frames->Acquire())
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        Frame frame = frames->Front();
+
+        whole   &= WholeFrame(frame);
+        ordered &= frame.number > last && (!lossless || frame.number == last + 1);
+
+        last = frame.number;
+        ++taken;
+    }
+
+    producer.join();
+
+    CHECK(whole, "TripleBuffer handed out a frame being drawn");
+    CHECK(ordered, "TripleBuffer frames out of order%s", lossless ? " or skipped" : "");
+
+    std::printf("TripleBuffer%s, %llu of %llu frames taken\n", lossless ? " lossless" : "", (unsigned long long) taken, (unsigned long long) FRAMES);
+}
+
+// items come out in order, with the consumer sleeping in WaitForItem whenever the queue is empty
+static void TestSpscQueue()
+{
+    constexpr int ITEMS = 200000;
+
+    SpscQueue<int, 4> queue;
+
+    std::thread producer([&]
+    {
+        // full, the consumer has the items to catch up on
+        for (int i = 0; i < ITEMS; )
+        {
+            if (queue.Push(i))
+                ++i;
+            else
+                std::this_thread::yield();
+        }
+    });
+
+    bool ordered = true;
+
+    for (int expected = 0; expected < ITEMS; )
+    {
+        int item;
+
+        if (!queue.Pop(item))
+        {
+            queue.WaitForItem();
+            continue;
+        }
+
+        ordered &= item == expected++;
+    }
+
+    producer.join();
+
+    CHECK(ordered, "SpscQueue items out of order");
+    std::printf("SpscQueue\n");
+}
+
+/*
+ * Reads the ring the way its comment tells other processes to while frames are published
+ * as fast as they can be: a read the seqlock lets through is always one whole frame.
+ */
+static void TestShmExport()
+{
+    std::string name = "/discovery-unit-tests-" + std::to_string(getpid());
+
+    auto shm = std::make_unique<ShmExport>(name, PixelFormat::XRGB8888);
+
+    int fd = shm_open(name.c_str(), O_RDONLY, 0);
+    CHECK(fd >= 0, "can't open %s", name.c_str());
+
+    struct stat info;
+    fstat(fd, &info);
+
+    const u8 *mapping = (const u8 *) mmap(NULL, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    CHECK(mapping != MAP_FAILED, "can't map %s", name.c_str());
+
+    const ShmHeader *header = (const ShmHeader *) mapping;
+    CHECK(header->magic == SHM_MAGIC && header->version == SHM_VERSION, "bad ShmHeader");
+
+    constexpr u64 FRAMES = 3000;
+    std::atomic<bool> done{false};
+
+    std::thread publisher([&]
+    {
+        static u32 pixels[SCREEN_HEIGHT][SCREEN_WIDTH];
+        u64 hashes[SCREEN_HEIGHT];
+        FrameDamage damage;
+
+        damage.MarkAll();
+
+        for (u64 n = 1; n <= FRAMES; ++n)
+        {
+            for (int line = 0; line < SCREEN_HEIGHT; ++line)
+            {
+                for (int x = 0; x < SCREEN_WIDTH; ++x)
+                    pixels[line][x] = (u32) n;
+
+                hashes[line] = n;
+            }
+
+            shm->Publish(pixels, sizeof(pixels[0]), hashes, damage, n, (u16) n);
+        }
+
+        done = true;
+    });
+
+    std::vector<u32> copy(SCREEN_WIDTH * SCREEN_HEIGHT);
+    u64 reads = 0, torn = 0;
+    bool whole = true;
+
+    while (!done)
+    {
+        u64 published = header->published.load(std::memory_order_acquire);
+        if (published == 0)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        int index = (published - 1) % header->slots;
+        const ShmSlot &slot = header->slot[index];
+
+        u32 sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence & 1)
+            continue;
+
+        std::memcpy(copy.data(), mapping + header->frames_offset + (u64) index * header->frame_bytes, copy.size() * 4);
+        u64 frame = slot.frame;
+        u32 keys  = slot.keys;
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != sequence)
+        {
+            ++torn;
+            continue;
+        }
+
+        for (u32 pixel : copy)
+            whole &= pixel == (u32) frame;
+
+        whole &= keys == (u16) frame;
+        ++reads;
+    }
+
+    publisher.join();
+    munmap((void *) mapping, info.st_size);
+    shm.reset();
+
+    CHECK(whole, "ShmExport reader got a torn frame past the seqlock");
+    std::printf("ShmExport, %llu reads, %llu retried\n", (unsigned long long) reads, (unsigned long long) torn);
+}
+
+int main()
+{
+    TestSimd("scalar");
+    TestSimd("sse2");
+    TestSimd("avx2");
+
+    // back to what the host picked at startup
+    if (!Simd::Use("avx2"))
+        Simd::Use("sse2");
+
+    TestThreadPool();
+    TestTripleBuffer(false);
+    TestTripleBuffer(true);
+    TestSpscQueue();
+    TestShmExport();
+
+    if (failures != 0)
+    {
+        std::printf("%d failed\n", failures);
+        return 1;
+    }
+
+    std::printf("all passed\n");
+    return 0;
+}